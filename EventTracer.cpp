@@ -0,0 +1,153 @@
+/*
+ * EventTracer.cpp - implementation file for EventTracer.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#include "EventTracer.h"
+#include "ThreadRegistry.h"
+#include <vector>
+
+// Initialize default values for static members.
+std::atomic<bool> EventTracer::enabled(true);
+
+void EventTracer::recordAt(uint64_t timestamp, PHASE phase, const char *name, uint32_t id, int32_t value) {
+	ThreadEvents &mine = ThreadRegistry<ThreadEvents>::local();
+
+	// Each slot is a small seqlock.  Mark it busy, fence so no field store can be seen before the mark, fill it in,
+	// then stamp it with its sequence number and bump head.  We are the only writer so relaxed stores are enough for
+	// the fields; writeChromeTrace() checks the stamp before and after copying them.
+	uint64_t head = mine.head.load(std::memory_order_relaxed);
+	Event &event = mine.events[head & (EVENT_CAPACITY - 1)];
+
+	event.sequence.store(BUSY, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	event.timestamp.store(timestamp, std::memory_order_relaxed);
+	event.name.store(name, std::memory_order_relaxed);
+	event.id.store(id, std::memory_order_relaxed);
+	event.value.store(value, std::memory_order_relaxed);
+	event.phase.store((char)phase, std::memory_order_relaxed);
+
+	event.sequence.store(head, std::memory_order_release);
+	mine.head.store(head + 1, std::memory_order_release);
+}
+
+void EventTracer::setEnabled(bool enable) {
+	enabled.store(enable, std::memory_order_relaxed);
+}
+
+void EventTracer::clear() {
+	ThreadRegistry<ThreadEvents>::forEach([](ThreadEvents &t, unsigned int) {
+		t.head.store(0, std::memory_order_release);
+	});
+}
+
+unsigned int EventTracer::writeChromeTrace(const std::string &fileName) {
+	// Create an out file stream and write the trace to it
+	std::ofstream traceFile(fileName.c_str());
+
+	if (!traceFile) {
+		throw std::ofstream::failure("Unable to open trace file.");
+	}
+
+	unsigned int written = writeChromeTrace(traceFile);
+	traceFile.close();
+
+	if (!traceFile) {
+		throw std::ofstream::failure("Unable to write trace file.");
+	}
+
+	return written;
+}
+
+unsigned int EventTracer::writeChromeTrace(std::ostream &out) {
+	// A plain copy of one event, taken from a ring buffer that may still be changing
+	struct Copy {
+		uint64_t timestamp;
+		const char *name;
+		uint32_t id;
+		int32_t value;
+		char phase;
+		uint64_t sequence;
+	};
+
+	std::vector<Copy> copies;
+	copies.reserve(EVENT_CAPACITY);
+	unsigned int written = 0;
+	bool first = true;
+
+	out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+	ThreadRegistry<ThreadEvents>::forEach([&](ThreadEvents &t, unsigned int slot) {
+		// Copy out everything the ring buffer still holds
+		uint64_t head = t.head.load(std::memory_order_acquire);
+		uint64_t oldest = (head > EVENT_CAPACITY) ? head - EVENT_CAPACITY : 0;
+
+		copies.clear();
+		for (uint64_t i = oldest; i < head; i++) {
+			Event &event = t.events[i & (EVENT_CAPACITY - 1)];
+
+			// Only keep the copy if the slot held event i both before and after it was taken, otherwise the
+			// owner was overwriting it and the copy may be torn
+			if (event.sequence.load(std::memory_order_acquire) != i) {
+				continue;
+			}
+			Copy copy = {event.timestamp.load(std::memory_order_relaxed),
+						event.name.load(std::memory_order_relaxed),
+						event.id.load(std::memory_order_relaxed),
+						event.value.load(std::memory_order_relaxed),
+						event.phase.load(std::memory_order_relaxed),
+						i};
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (event.sequence.load(std::memory_order_relaxed) != i) {
+				continue;
+			}
+			copies.push_back(copy);
+		}
+
+		// Also drop anything the owner has wrapped onto since, including the slot it may be writing right now
+		uint64_t newHead = t.head.load(std::memory_order_acquire);
+		uint64_t firstValid = (newHead >= EVENT_CAPACITY) ? newHead - EVENT_CAPACITY + 1 : 0;
+		size_t skip = 0;
+		while (skip < copies.size() && copies[skip].sequence < firstValid) {
+			skip++;
+		}
+
+		if (skip >= copies.size()) {
+			return;
+		}
+
+		// Name the thread's track, then write its events
+		out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << slot
+			<< ",\"args\":{\"name\":\"brew thread " << slot << "\"}}";
+		first = false;
+
+		for (size_t i = skip; i < copies.size(); i++) {
+			const Copy &c = copies[i];
+
+			// Chrome trace timestamps are in microseconds
+			out << ",\n{\"ph\":\"" << c.phase << "\",\"pid\":1,\"tid\":" << slot
+				<< ",\"ts\":" << c.timestamp / 1000 << "." << (char)('0' + c.timestamp / 100 % 10)
+				<< (char)('0' + c.timestamp / 10 % 10) << (char)('0' + c.timestamp % 10);
+
+			if (c.phase == COUNTER) {
+				out << ",\"name\":\"" << c.name << " " << c.id << "\",\"args\":{\"value\":" << c.value << "}}";
+			} else {
+				out << ",\"name\":\"" << c.name << "\"";
+				if (c.phase == ASYNC_BEGIN || c.phase == ASYNC_END) {
+					out << ",\"cat\":\"brew\",\"id\":" << c.id;
+				} else if (c.phase == INSTANT) {
+					out << ",\"s\":\"t\"";
+				}
+				out << ",\"args\":{\"id\":" << c.id << ",\"value\":" << c.value << "}}";
+			}
+			written++;
+		}
+	});
+
+	out << "\n]}\n";
+
+	return written;
+}
@@ -0,0 +1,163 @@
+/*
+ * EventTracer.h - timeline tracing for the brew I/O stack.  Each thread records events into its own fixed size ring
+ * 			buffer (the oldest events are overwritten once it fills), timestamped with CLOCK_MONOTONIC_RAW so the
+ * 			timeline is not bent by NTP slewing.  writeChromeTrace() dumps every thread's buffer as Chrome trace JSON,
+ * 			which can be opened in Perfetto (ui.perfetto.dev) or chrome://tracing.
+ *
+ * 			Events are:	- BEGIN/END - a span on the recording thread's track.
+ * 						- ASYNC_BEGIN/ASYNC_END - a span on its own track keyed by id, e.g. one per chip select.
+ * 						- INSTANT - a single point in time.
+ * 						- COUNTER - a value plotted over time on a track named "<name> <id>", e.g. a pin's level.
+ *
+ * 			Event names must be string literals (only the pointer is stored).  Recording is compiled in only when
+ * 			BREW_EVENT_TRACING is defined; without it the BREW_TRACE_*() macros expand to nothing.  Recording costs a
+ * 			clock read and a handful of stores, see bench/TracerBench.cpp.
+ *
+ * 			Example usage:	- BREW_TRACE_COUNTER("PinOutput", pin, 1);
+ * 							- EventTracer::writeChromeTrace("mash.json");
+ *
+ * 	Requires C++11 (-std=c++0x command line option)
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#ifndef EVENTTRACER_H_
+#define EVENTTRACER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <time.h>
+
+class EventTracer {
+public:
+	/*
+	 * 	PHASE - the kind of event.  The values are the Chrome trace "ph" characters.
+	 */
+	enum PHASE {BEGIN='B', END='E', ASYNC_BEGIN='b', ASYNC_END='e', INSTANT='i', COUNTER='C'};
+
+	/*
+	 * 	EVENT_CAPACITY - number of events each thread's ring buffer holds.  Must be a power of two.
+	 */
+	static const unsigned int EVENT_CAPACITY = 8192;
+
+	/*
+	 * 	record() - adds an event to the calling thread's ring buffer.  Does nothing while tracing is disabled.
+	 * 	@params - phase - the kind of event.
+	 * 			- name - string literal naming the event.
+	 * 			- id - chip select, pin number, etc.  Keys async spans and counters.
+	 * 			- value - counter value, or an extra argument shown with other events.
+	 */
+	static void record(PHASE phase, const char *name, uint32_t id, int32_t value) {
+		if (enabled.load(std::memory_order_relaxed)) {
+			recordAt(now(), phase, name, id, value);
+		}
+	}
+
+	/*
+	 * 	recordAt() - same as record() but with a caller supplied timestamp and no enabled check.
+	 */
+	static void recordAt(uint64_t timestamp, PHASE phase, const char *name, uint32_t id, int32_t value);
+
+	/*
+	 * 	setEnabled() - turns recording on or off at run time.  Tracing starts enabled.
+	 */
+	static void setEnabled(bool enable);
+
+	/*
+	 * 	clear() - discards every event recorded so far.  Should not be called while other threads are recording.
+	 */
+	static void clear();
+
+	/*
+	 * 	writeChromeTrace() - writes every thread's events as Chrome trace JSON.  May be called while other threads are
+	 * 			recording; events overwritten during the dump are left out.
+	 * 	@params - fileName / out - where to write the trace.
+	 * 	@return - the number of events written.
+	 * 	@throws - std::ofstream::failure if the file cannot be written.
+	 */
+	static unsigned int writeChromeTrace(const std::string &fileName);
+	static unsigned int writeChromeTrace(std::ostream &out);
+
+	/*
+	 * 	now() - the timestamp used for events, in nanoseconds.
+	 */
+	static uint64_t now() {
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	}
+
+	/*
+	 * 	Event - one recorded event, see record() for the fields.  sequence is the event's number in its thread
+	 * 			(the head it was written at), or BUSY while the owner is writing it.
+	 */
+	struct Event {
+		std::atomic<uint64_t> sequence;
+		std::atomic<uint64_t> timestamp;
+		std::atomic<const char *> name;
+		std::atomic<uint32_t> id;
+		std::atomic<int32_t> value;
+		std::atomic<char> phase;
+	};
+
+	/*
+	 * 	BUSY - Event::sequence of a slot being written.
+	 */
+	static const uint64_t BUSY = ~0ULL;
+
+	/*
+	 * 	ThreadEvents - one thread's ring buffer.  head counts every event ever written, so the newest event is
+	 * 			at (head - 1) & (EVENT_CAPACITY - 1).  Only the owning thread writes.
+	 */
+	struct ThreadEvents {
+		Event events[EVENT_CAPACITY];
+		std::atomic<uint64_t> head;
+	};
+
+	/*
+	 * 	ScopedSpan - records BEGIN on construction and END on destruction.
+	 */
+	class ScopedSpan {
+	public:
+		ScopedSpan(const char *newName, uint32_t newId) : name(newName), id(newId) { record(BEGIN, name, id, 0); }
+		~ScopedSpan() { record(END, name, id, 0); }
+
+	private:
+		const char *name;
+		uint32_t id;
+	};
+
+private:
+	/*
+	 * 	enabled - whether record() stores events.
+	 */
+	static std::atomic<bool> enabled;
+};
+
+/*
+ * 	BREW_TRACE_*() - record trace events when built with BREW_EVENT_TRACING, otherwise expand to nothing.
+ * 			BREW_TRACE_SCOPE() traces the rest of the enclosing scope and may be used at most once per scope.
+ */
+#ifdef BREW_EVENT_TRACING
+#define BREW_TRACE_BEGIN(name, id) EventTracer::record(EventTracer::BEGIN, name, id, 0)
+#define BREW_TRACE_END(name, id) EventTracer::record(EventTracer::END, name, id, 0)
+#define BREW_TRACE_ASYNC_BEGIN(name, id) EventTracer::record(EventTracer::ASYNC_BEGIN, name, id, 0)
+#define BREW_TRACE_ASYNC_END(name, id) EventTracer::record(EventTracer::ASYNC_END, name, id, 0)
+#define BREW_TRACE_INSTANT(name, id, value) EventTracer::record(EventTracer::INSTANT, name, id, value)
+#define BREW_TRACE_COUNTER(name, id, value) EventTracer::record(EventTracer::COUNTER, name, id, value)
+#define BREW_TRACE_SCOPE(name, id) EventTracer::ScopedSpan traceScopeSpan(name, id)
+#else
+#define BREW_TRACE_BEGIN(name, id)
+#define BREW_TRACE_END(name, id)
+#define BREW_TRACE_ASYNC_BEGIN(name, id)
+#define BREW_TRACE_ASYNC_END(name, id)
+#define BREW_TRACE_INSTANT(name, id, value)
+#define BREW_TRACE_COUNTER(name, id, value)
+#define BREW_TRACE_SCOPE(name, id)
+#endif
+
+#endif /* EVENTTRACER_H_ */
@@ -0,0 +1,132 @@
+/*
+ * LatencyHistogram.cpp - implementation file for LatencyHistogram.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#include "LatencyHistogram.h"
+#include "ThreadRegistry.h"
+#include <cmath>
+
+void LatencyHistogram::record(OPERATION op, uint64_t nanoseconds) {
+	ThreadHistograms &mine = ThreadRegistry<ThreadHistograms>::local();
+
+	// We are the only writer of our histograms, so a relaxed load & store is enough (and avoids a locked
+	// read-modify-write on every sample).
+	std::atomic<uint64_t> &bucket = mine.counts[op][bucketIndex(nanoseconds)];
+	bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	mine.total[op].store(mine.total[op].load(std::memory_order_relaxed) + nanoseconds, std::memory_order_relaxed);
+
+	if (nanoseconds > mine.max[op].load(std::memory_order_relaxed)) {
+		mine.max[op].store(nanoseconds, std::memory_order_relaxed);
+	}
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot(OPERATION op) {
+	// Merge every thread's buckets into one histogram
+	uint64_t merged[BUCKET_COUNT] = {0};
+	uint64_t count = 0;
+	uint64_t total = 0;
+	uint64_t max = 0;
+
+	ThreadRegistry<ThreadHistograms>::forEach([&](ThreadHistograms &h, unsigned int) {
+		for (unsigned int i = 0; i < BUCKET_COUNT; i++) {
+			uint64_t c = h.counts[op][i].load(std::memory_order_relaxed);
+			merged[i] += c;
+			count += c;
+		}
+		total += h.total[op].load(std::memory_order_relaxed);
+
+		uint64_t threadMax = h.max[op].load(std::memory_order_relaxed);
+		if (threadMax > max) {
+			max = threadMax;
+		}
+	});
+
+	Snapshot result = {count, 0, 0, 0, 0, max};
+	if (count == 0) {
+		return result;
+	}
+	result.mean = total / count;
+
+	// Walk the buckets once, filling in each percentile as its rank is reached.  Ranks are rounded up so p999 of
+	// fewer than 1000 samples is the largest sample.
+	const double quantiles[3] = {0.50, 0.99, 0.999};
+	uint64_t *targets[3] = {&result.p50, &result.p99, &result.p999};
+	unsigned int next = 0;
+	uint64_t seen = 0;
+
+	for (unsigned int i = 0; i < BUCKET_COUNT && next < 3; i++) {
+		seen += merged[i];
+		while (next < 3) {
+			uint64_t rank = (uint64_t)std::ceil(quantiles[next] * count);
+			if (seen < rank) {
+				break;
+			}
+
+			// Report the top of the bucket, but never more than the largest sample actually seen
+			uint64_t value = bucketUpperBound(i);
+			*targets[next] = (value < max) ? value : max;
+			next++;
+		}
+	}
+
+	return result;
+}
+
+void LatencyHistogram::reset() {
+	ThreadRegistry<ThreadHistograms>::forEach([](ThreadHistograms &h, unsigned int) {
+		for (unsigned int op = 0; op < OPERATION_COUNT; op++) {
+			for (unsigned int i = 0; i < BUCKET_COUNT; i++) {
+				h.counts[op][i].store(0, std::memory_order_relaxed);
+			}
+			h.total[op].store(0, std::memory_order_relaxed);
+			h.max[op].store(0, std::memory_order_relaxed);
+		}
+	});
+}
+
+const char *LatencyHistogram::operationName(OPERATION op) {
+	switch (op) {
+	case SPI_TRANSFER:	return "spi_transfer";
+	case DRDY_WAIT:		return "drdy_wait";
+	case SYSFS_WRITE:	return "sysfs_write";
+	case SYSFS_READ:	return "sysfs_read";
+	case GPIO_WRITE:	return "gpio_write";
+	default:			return "unknown";
+	}
+}
+
+unsigned int LatencyHistogram::bucketIndex(uint64_t nanoseconds) {
+	// Small values get a bucket each
+	if (nanoseconds < SUB_BUCKETS) {
+		return (unsigned int)nanoseconds;
+	}
+
+	// Otherwise the exponent picks the power of two and the SUB_BUCKET_BITS below the leading one pick the sub-bucket
+	unsigned int exponent = 63 - __builtin_clzll(nanoseconds);
+	if (exponent > MAX_EXPONENT) {
+		return BUCKET_COUNT - 1;
+	}
+
+	unsigned int subBucket = (nanoseconds >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+	return SUB_BUCKETS + (exponent - SUB_BUCKET_BITS) * SUB_BUCKETS + subBucket;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(unsigned int index) {
+	if (index < SUB_BUCKETS) {
+		return index;
+	}
+
+	// The last bucket also holds everything from 2^(MAX_EXPONENT + 1) up
+	if (index >= BUCKET_COUNT - 1) {
+		return UINT64_MAX;
+	}
+
+	unsigned int exponent = (index - SUB_BUCKETS) / SUB_BUCKETS + SUB_BUCKET_BITS;
+	uint64_t subBucket = (index - SUB_BUCKETS) % SUB_BUCKETS;
+	uint64_t width = 1ULL << (exponent - SUB_BUCKET_BITS);
+
+	return (1ULL << exponent) + (subBucket + 1) * width - 1;
+}
@@ -0,0 +1,137 @@
+/*
+ * LatencyHistogram.h - per-operation latency histograms for the brew I/O stack.  Each thread records into its own
+ * 			log-bucketed (HDR style) histogram, so recording is a clock read and a couple of plain stores with no locks
+ * 			or atomic read-modify-writes.  snapshot() merges every thread's histogram without stopping the writers.
+ *
+ * 			Bucketing keeps 16 linear sub-buckets per power of two, so any reported value is within ~6% of the real
+ * 			one.  Values are in nanoseconds and anything from 2^38 ns (~4.5 min) up lands in the last bucket.
+ *
+ * 			Recording is compiled in only when BREW_LATENCY_HISTOGRAMS is defined.  Without it BREW_LATENCY_SCOPE()
+ * 			expands to nothing, so the instrumented hot paths cost nothing, and snapshot() reports zero counts.
+ *
+ * 			Example usage:	- { BREW_LATENCY_SCOPE(SPI_TRANSFER); ioctl(...); }
+ * 							- LatencyHistogram::Snapshot s = LatencyHistogram::snapshot(LatencyHistogram::SPI_TRANSFER);
+ *
+ * 	Requires C++11 (-std=c++0x command line option)
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#ifndef LATENCYHISTOGRAM_H_
+#define LATENCYHISTOGRAM_H_
+
+#include <atomic>
+#include <cstdint>
+#include <time.h>
+
+class LatencyHistogram {
+public:
+	/*
+	 * 	OPERATION - the instrumented operations, one histogram each.
+	 */
+	enum OPERATION {SPI_TRANSFER,	// TemperatureProbe spidev ioctl
+					DRDY_WAIT,		// TemperatureProbe waiting for DRDY to go low
+					SYSFS_WRITE,	// PinOutput On()/Off()
+					SYSFS_READ,		// PinInput getValue()
+					GPIO_WRITE,		// gpioPin On()/Off()
+					OPERATION_COUNT};
+
+	/*
+	 * 	Snapshot - merged view of one operation's histogram.  All times are in nanoseconds.
+	 */
+	struct Snapshot {
+		uint64_t count;
+		uint64_t mean;
+		uint64_t p50;
+		uint64_t p99;
+		uint64_t p999;
+		uint64_t max;
+	};
+
+	/*
+	 * 	record() - adds one sample to the calling thread's histogram for op.
+	 * 	@params - op - the operation the sample belongs to.
+	 * 			- nanoseconds - how long the operation took.
+	 */
+	static void record(OPERATION op, uint64_t nanoseconds);
+
+	/*
+	 * 	snapshot() - merges every thread's histogram for op.  Samples recorded while the merge runs may or may not
+	 * 			be included.
+	 * 	@return - the merged count, mean, percentiles and max for op.
+	 */
+	static Snapshot snapshot(OPERATION op);
+
+	/*
+	 * 	reset() - zeroes every thread's histograms.  A sample being recorded at the same moment may survive the reset.
+	 */
+	static void reset();
+
+	/*
+	 * 	operationName() - returns a printable name for op, e.g. "spi_transfer".
+	 */
+	static const char *operationName(OPERATION op);
+
+	/*
+	 * 	now() - monotonic timestamp in nanoseconds used for all measurements.
+	 */
+	static uint64_t now() {
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	}
+
+	/*
+	 * 	ScopedTimer - records the time between its construction and destruction against op.
+	 */
+	class ScopedTimer {
+	public:
+		explicit ScopedTimer(OPERATION newOp) : op(newOp), start(now()) {}
+		~ScopedTimer() { record(op, now() - start); }
+
+	private:
+		OPERATION op;
+		uint64_t start;
+	};
+
+	/*
+	 * 	Bucket layout: values below SUB_BUCKETS get a bucket each, above that every power of two up to
+	 * 	2^MAX_EXPONENT is split into SUB_BUCKETS equal buckets.
+	 */
+	static const unsigned int SUB_BUCKET_BITS = 4;
+	static const unsigned int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+	static const unsigned int MAX_EXPONENT = 37;
+	static const unsigned int BUCKET_COUNT = SUB_BUCKETS + (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+	/*
+	 * 	bucketIndex() - returns the bucket nanoseconds falls in.
+	 */
+	static unsigned int bucketIndex(uint64_t nanoseconds);
+
+	/*
+	 * 	bucketUpperBound() - returns the largest value that falls in bucket index.  The last bucket is open ended, so
+	 * 			its bound is UINT64_MAX; snapshot() never reports more than the largest sample.
+	 */
+	static uint64_t bucketUpperBound(unsigned int index);
+
+	/*
+	 * 	ThreadHistograms - one thread's histograms.  Only the owning thread writes; snapshot() reads.
+	 */
+	struct ThreadHistograms {
+		std::atomic<uint64_t> counts[OPERATION_COUNT][BUCKET_COUNT];
+		std::atomic<uint64_t> total[OPERATION_COUNT];
+		std::atomic<uint64_t> max[OPERATION_COUNT];
+	};
+};
+
+/*
+ * 	BREW_LATENCY_SCOPE() - times the rest of the enclosing scope as LatencyHistogram::op.  Use at most once per scope.
+ */
+#ifdef BREW_LATENCY_HISTOGRAMS
+#define BREW_LATENCY_SCOPE(op) LatencyHistogram::ScopedTimer latencyScopeTimer(LatencyHistogram::op)
+#else
+#define BREW_LATENCY_SCOPE(op)
+#endif
+
+#endif /* LATENCYHISTOGRAM_H_ */
@@ -1,5 +1,6 @@
 /*
- * PinAssignments.h - defines what is connected to which pin on the Raspberry Pi.
+ * PinAssignments.h - defines what is connected to which pin on the Raspberry Pi.  Conflicting assignments are
+ * 		caught at compile time by the static_asserts at the bottom.
  *
  *  Created on: Nov 30, 2013
  *      Author: Jeff H.
@@ -22,4 +23,24 @@ const static unsigned int HE_PIN = 18;
 /*	PUMP GPIO PIN	*/
 const static unsigned int PUMP_PIN = 23;
 
+/*	NUMBER OF BCM2835 GPIO PINS	*/
+const static unsigned int GPIO_PIN_COUNT = 54;
+
+/*
+ *	isReservedPin() - true if pin belongs to the SPI bus or the MAX31865 interface and must not be driven by
+ *			anything else.
+ */
+constexpr bool isReservedPin(unsigned int pin) {
+	return pin == SPI_CLK || pin == SPI_MOSI || pin == SPI_MISO || pin == SPI_CE0 || pin == SPI_CE1 || pin == DRDY_PIN;
+}
+
+/*	COMPILE TIME CHECKS OF THE PIN MAP	*/
+static_assert(DRDY_PIN < GPIO_PIN_COUNT && HE_PIN < GPIO_PIN_COUNT && PUMP_PIN < GPIO_PIN_COUNT,
+		"Pin assignment is not a BCM2835 GPIO pin.");
+static_assert(DRDY_PIN != SPI_CLK && DRDY_PIN != SPI_MOSI && DRDY_PIN != SPI_MISO && DRDY_PIN != SPI_CE0 &&
+		DRDY_PIN != SPI_CE1, "DRDY_PIN conflicts with the SPI pins.");
+static_assert(!isReservedPin(HE_PIN), "HE_PIN conflicts with the SPI pins.");
+static_assert(!isReservedPin(PUMP_PIN), "PUMP_PIN conflicts with the SPI pins.");
+static_assert(HE_PIN != PUMP_PIN, "HE_PIN and PUMP_PIN are the same pin.");
+
 #endif /* PINASSIGNMENTS_H_ */
@@ -7,11 +7,14 @@
 
 #include "PinInput.h"
 
+// Initialize default values for static members.
+std::string PinInput::systemRoot = "";
+
 PinInput::PinInput(unsigned int newPin) :
 	pin(newPin)
 {
 	// Create an out file stream
-	std::ofstream fileGPIO("/sys/class/gpio/export");
+	std::ofstream fileGPIO((systemRoot + "/sys/class/gpio/export").c_str());
 
 	// Export the GPIO pin as long as the file opened correctly.
 	if (fileGPIO) {
@@ -22,7 +25,7 @@ PinInput::PinInput(unsigned int newPin) :
 	}
 
 	// Open the direction file, tell it to be an input, and then close the file
-	std::string setDirStr = "/sys/class/gpio/gpio" + std::to_string(pin) + "/direction";
+	std::string setDirStr = systemRoot + "/sys/class/gpio/gpio" + std::to_string(pin) + "/direction";
 	fileGPIO.open(setDirStr.c_str());
 
 	if(fileGPIO) {
@@ -33,12 +36,12 @@ PinInput::PinInput(unsigned int newPin) :
 	}
 
 	// Setup the string used to read the value
-	pinValueFileString = "/sys/class/gpio/gpio" + std::to_string(pin) + "/value";
+	pinValueFileString = systemRoot + "/sys/class/gpio/gpio" + std::to_string(pin) + "/value";
 }
 
 PinInput::~PinInput() {
 	// Create an out file stream and unexport the GPIO pin
-	std::ofstream fileGPIO("/sys/class/gpio/unexport");
+	std::ofstream fileGPIO((systemRoot + "/sys/class/gpio/unexport").c_str());
 
 	if(fileGPIO) {
 		fileGPIO << pin;
@@ -49,6 +52,8 @@ PinInput::~PinInput() {
 }
 
 PinInput::PIN_VALUE PinInput::getValue() const {
+	BREW_LATENCY_SCOPE(SYSFS_READ);
+
 	// Create an in file stream.
 	std::ifstream valueFile(pinValueFileString.c_str());
 
@@ -69,3 +74,6 @@ PinInput::PIN_VALUE PinInput::getValue() const {
 	}
 }
 
+void PinInput::setSystemRoot(const std::string &root) {
+	systemRoot = root;
+}
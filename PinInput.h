@@ -15,6 +15,7 @@
 
 #include <fstream>
 #include <string>
+#include "LatencyHistogram.h"
 
 class PinInput {
 public:
@@ -36,6 +37,13 @@ public:
 	 */
 	PIN_VALUE getValue() const;
 
+	/*
+	 * 	setSystemRoot() - sets the directory /sys is looked for in, e.g. a fake sysfs for testing.  Defaults to ""
+	 * 			(the real root).
+	 * 	@post - pins constructed afterwards use root.
+	 */
+	static void setSystemRoot(const std::string &root);
+
 private:
 	/*
 	 * 	pin - holds the pin that this class controls.
@@ -46,6 +54,11 @@ private:
 	 * 	pinValueFileString - stores the file name used for reading the pin's value.
 	 */
 	std::string pinValueFileString;
+
+	/*
+	 * 	systemRoot - prefix for the /sys paths.
+	 */
+	static std::string systemRoot;
 };
 
 #endif /* PININPUT_H_ */
@@ -7,11 +7,14 @@
 
 #include "PinOutput.h"
 
+// Initialize default values for static members.
+std::string PinOutput::systemRoot = "";
+
 PinOutput::PinOutput(unsigned int newPin) :
 	pin(newPin), isHigh(false)
 {
 	// Create an out file stream
-	std::ofstream fileGPIO("/sys/class/gpio/export");
+	std::ofstream fileGPIO((systemRoot + "/sys/class/gpio/export").c_str());
 
 	// Export the GPIO pin as long as the file opened correctly.
 	if (fileGPIO) {
@@ -22,7 +25,7 @@ PinOutput::PinOutput(unsigned int newPin) :
 	}
 
 	// Open the direction file, tell it to be an output, and then close the file
-	std::string setDirStr = "/sys/class/gpio/gpio" + std::to_string(pin) + "/direction";
+	std::string setDirStr = systemRoot + "/sys/class/gpio/gpio" + std::to_string(pin) + "/direction";
 	fileGPIO.open(setDirStr.c_str());
 
 	if(fileGPIO) {
@@ -33,7 +36,7 @@ PinOutput::PinOutput(unsigned int newPin) :
 	}
 
 	// Construct the file name used for turning the pin on & off.
-	onOffFileString = "/sys/class/gpio/gpio" + std::to_string(pin) + "/value";
+	onOffFileString = systemRoot + "/sys/class/gpio/gpio" + std::to_string(pin) + "/value";
 
 	// Make sure the pin is currently off
 	this->Off();
@@ -41,7 +44,7 @@ PinOutput::PinOutput(unsigned int newPin) :
 
 PinOutput::~PinOutput() {
 	// Create an out file stream and unexport the GPIO pin
-	std::ofstream fileGPIO("/sys/class/gpio/unexport");
+	std::ofstream fileGPIO((systemRoot + "/sys/class/gpio/unexport").c_str());
 
 	if(fileGPIO) {
 		fileGPIO << pin;
@@ -52,6 +55,8 @@ PinOutput::~PinOutput() {
 }
 
 void PinOutput::On() {
+	BREW_LATENCY_SCOPE(SYSFS_WRITE);
+
 	// Create an out file stream, open the value file, and tell it to turn the pin on.
 	std::ofstream onFile(onOffFileString.c_str());
 
@@ -61,12 +66,15 @@ void PinOutput::On() {
 
 		// Update isHigh
 		isHigh = true;
+		BREW_TRACE_COUNTER("PinOutput", pin, 1);
 	} else {
 		throw std::ofstream::failure("Unable to turn on GPIO pin.");
 	}
 }
 
 void PinOutput::Off() {
+	BREW_LATENCY_SCOPE(SYSFS_WRITE);
+
 	// Create an out file stream, open the value file, and tell it to turn the pin off.
 	std::ofstream offFile(onOffFileString.c_str());
 
@@ -76,6 +84,7 @@ void PinOutput::Off() {
 
 		// Update isHigh
 		isHigh = false;
+		BREW_TRACE_COUNTER("PinOutput", pin, 0);
 	} else {
 		throw std::ofstream::failure("Unable to turn off GPIO pin.");
 	}
@@ -89,3 +98,6 @@ bool PinOutput::isOff() const {
 	return !isHigh;
 }
 
+void PinOutput::setSystemRoot(const std::string &root) {
+	systemRoot = root;
+}
@@ -17,6 +17,8 @@
 
 #include <fstream>
 #include <string>
+#include "LatencyHistogram.h"
+#include "EventTracer.h"
 
 class PinOutput {
 public:
@@ -52,6 +54,13 @@ public:
 	 */
 	bool isOff() const;
 
+	/*
+	 * 	setSystemRoot() - sets the directory /sys is looked for in, e.g. a fake sysfs for testing.  Defaults to ""
+	 * 			(the real root).
+	 * 	@post - pins constructed afterwards use root.
+	 */
+	static void setSystemRoot(const std::string &root);
+
 private:
 	/*
 	 * 	pin - holds the pin that this class controls.
@@ -67,6 +76,11 @@ private:
 	 * 	isHigh - stores true if the pin is high/on and false if it is low/off.
 	 */
 	bool isHigh;
+
+	/*
+	 * 	systemRoot - prefix for the /sys paths.
+	 */
+	static std::string systemRoot;
 };
 
 #endif /* PINOUTPUT_H_ */
@@ -0,0 +1,94 @@
+/*
+ * SampleFilter.cpp - implementation file for SampleFilter.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#include "SampleFilter.h"
+
+ExponentialMovingAverage::ExponentialMovingAverage(double newAlpha) :
+	alpha(newAlpha), average(0), seeded(false)
+{
+	if (!(alpha > 0 && alpha <= 1)) {
+		throw std::runtime_error("EMA alpha must be in (0, 1].");
+	}
+}
+
+double ExponentialMovingAverage::filter(double sample) {
+	if (seeded) {
+		average += alpha * (sample - average);
+	} else {
+		average = sample;
+		seeded = true;
+	}
+
+	return average;
+}
+
+void ExponentialMovingAverage::reset() {
+	seeded = false;
+}
+
+RateOfChangeRejector::RateOfChangeRejector(double newMaxStep, unsigned int newMaxRejections) :
+	maxStep(newMaxStep), maxRejections(newMaxRejections), lastAccepted(0), seeded(false), consecutiveRejections(0),
+	rejectedCount(0)
+{
+}
+
+double RateOfChangeRejector::filter(double sample) {
+	double step = sample - lastAccepted;
+	if (step < 0) {
+		step = -step;
+	}
+
+	// Reject the sample if it jumped too far, unless we have already rejected too many in a row
+	if (seeded && step > maxStep && consecutiveRejections < maxRejections) {
+		consecutiveRejections++;
+		rejectedCount++;
+		return lastAccepted;
+	}
+
+	lastAccepted = sample;
+	seeded = true;
+	consecutiveRejections = 0;
+
+	return lastAccepted;
+}
+
+void RateOfChangeRejector::reset() {
+	seeded = false;
+	consecutiveRejections = 0;
+	rejectedCount = 0;
+}
+
+unsigned long RateOfChangeRejector::getRejectedCount() const {
+	return rejectedCount;
+}
+
+FilterChain::FilterChain() :
+	stageCount(0)
+{
+}
+
+void FilterChain::append(SampleFilter &stage) {
+	if (stageCount == MAX_STAGES) {
+		throw std::runtime_error("FilterChain is full.");
+	}
+
+	stages[stageCount++] = &stage;
+}
+
+double FilterChain::filter(double sample) {
+	for (unsigned int i = 0; i < stageCount; i++) {
+		sample = stages[i]->filter(sample);
+	}
+
+	return sample;
+}
+
+void FilterChain::reset() {
+	for (unsigned int i = 0; i < stageCount; i++) {
+		stages[i]->reset();
+	}
+}
@@ -0,0 +1,261 @@
+/*
+ * SampleFilter.h - streaming filters for cleaning up temperature samples, e.g. the spikes pump cycling and heater
+ * 			switching put on the RTD readings.  Every filter keeps its state in fixed size members, so nothing is
+ * 			allocated per sample, and takes O(1) (or O(log window) for the median) time per sample.
+ *
+ * 			Filters can be used on their own, chained with FilterChain, or attached to a TemperatureProbe with
+ * 			setFilter() so getTemperature() returns filtered values.
+ *
+ * 			Example usage:	- RateOfChangeRejector spikes(2.0, 3);
+ * 							- SlidingMedian<9> median;
+ * 							- FilterChain chain;
+ * 							- chain.append(spikes);
+ * 							- chain.append(median);
+ * 							- probe.setFilter(&chain);
+ *
+ * 	Requires C++11 (-std=c++0x command line option)
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#ifndef SAMPLEFILTER_H_
+#define SAMPLEFILTER_H_
+
+#include <stdexcept>
+
+class SampleFilter {
+public:
+	virtual ~SampleFilter() {}
+
+	/*
+	 * 	filter() - feeds the next sample through the filter.
+	 * 	@params - sample - the next raw sample.
+	 * 	@return - the filtered value.
+	 */
+	virtual double filter(double sample) = 0;
+
+	/*
+	 * 	reset() - forgets all previous samples.
+	 * 	@post - the next sample is treated as the first.
+	 */
+	virtual void reset() = 0;
+};
+
+/*
+ * 	SlidingMedian - median of the last WINDOW samples.  The window is split into two heaps, a max-heap of the lower
+ * 			half and a min-heap of the upper half, which track each sample's position so the oldest one can be
+ * 			removed in O(log WINDOW).  Until WINDOW samples have been seen it is the median of those seen so far.
+ */
+template<unsigned int WINDOW>
+class SlidingMedian : public SampleFilter {
+	static_assert(WINDOW > 0, "SlidingMedian needs a window of at least 1");
+
+public:
+	SlidingMedian() : size(0), next(0), lowCount(0), highCount(0) {}
+
+	double filter(double sample) {
+		// Reuse the oldest sample's slot
+		unsigned int slot = next;
+		if (size == WINDOW) {
+			remove(slot);
+		} else {
+			size++;
+		}
+		next = (next + 1 == WINDOW) ? 0 : next + 1;
+
+		// Add the sample to whichever half it belongs in, then move one sample across if the halves are out of
+		// balance.  The low half holds the extra sample when the count is odd.
+		values[slot] = sample;
+		if (lowCount == 0 || sample <= values[low[0]]) {
+			push(true, slot);
+		} else {
+			push(false, slot);
+		}
+
+		if (lowCount > highCount + 1) {
+			push(false, pop(true));
+		} else if (highCount > lowCount) {
+			push(true, pop(false));
+		}
+
+		if (lowCount > highCount) {
+			return values[low[0]];
+		}
+		return (values[low[0]] + values[high[0]]) / 2;
+	}
+
+	void reset() {
+		size = 0;
+		next = 0;
+		lowCount = 0;
+		highCount = 0;
+	}
+
+private:
+	double values[WINDOW];		// samples, indexed by slot
+	unsigned int low[WINDOW];	// max-heap of the slots in the lower half
+	unsigned int high[WINDOW];	// min-heap of the slots in the upper half
+	unsigned int position[WINDOW];	// where each slot sits in its heap
+	bool inLow[WINDOW];			// which heap each slot is in
+	unsigned int size;			// samples in the window
+	unsigned int next;			// slot the next sample goes in (the oldest once the window is full)
+	unsigned int lowCount;
+	unsigned int highCount;
+
+	unsigned int *heap(bool isLow) { return isLow ? low : high; }
+	unsigned int &count(bool isLow) { return isLow ? lowCount : highCount; }
+
+	// Should slot a sit above slot b in the heap?
+	bool above(bool isLow, unsigned int a, unsigned int b) const {
+		return isLow ? values[a] > values[b] : values[a] < values[b];
+	}
+
+	void place(bool isLow, unsigned int pos, unsigned int slot) {
+		heap(isLow)[pos] = slot;
+		position[slot] = pos;
+		inLow[slot] = isLow;
+	}
+
+	void siftUp(bool isLow, unsigned int pos) {
+		unsigned int *h = heap(isLow);
+		unsigned int slot = h[pos];
+		while (pos > 0) {
+			unsigned int parent = (pos - 1) / 2;
+			if (!above(isLow, slot, h[parent])) {
+				break;
+			}
+			place(isLow, pos, h[parent]);
+			pos = parent;
+		}
+		place(isLow, pos, slot);
+	}
+
+	void siftDown(bool isLow, unsigned int pos) {
+		unsigned int *h = heap(isLow);
+		unsigned int n = count(isLow);
+		unsigned int slot = h[pos];
+		while (true) {
+			unsigned int child = 2 * pos + 1;
+			if (child >= n) {
+				break;
+			}
+			if (child + 1 < n && above(isLow, h[child + 1], h[child])) {
+				child++;
+			}
+			if (!above(isLow, h[child], slot)) {
+				break;
+			}
+			place(isLow, pos, h[child]);
+			pos = child;
+		}
+		place(isLow, pos, slot);
+	}
+
+	void push(bool isLow, unsigned int slot) {
+		unsigned int pos = count(isLow)++;
+		place(isLow, pos, slot);
+		siftUp(isLow, pos);
+	}
+
+	unsigned int pop(bool isLow) {
+		unsigned int *h = heap(isLow);
+		unsigned int top = h[0];
+		unsigned int last = h[--count(isLow)];
+		if (count(isLow) > 0) {
+			place(isLow, 0, last);
+			siftDown(isLow, 0);
+		}
+		return top;
+	}
+
+	void remove(unsigned int slot) {
+		bool isLow = inLow[slot];
+		unsigned int *h = heap(isLow);
+		unsigned int pos = position[slot];
+		unsigned int last = h[--count(isLow)];
+		if (pos < count(isLow)) {
+			// Move the heap's last slot into the hole and let it find its place in either direction
+			place(isLow, pos, last);
+			siftUp(isLow, pos);
+			siftDown(isLow, position[last]);
+		}
+	}
+};
+
+/*
+ * 	ExponentialMovingAverage - y += alpha * (x - y).  A smaller alpha smooths more and lags more.  The first sample
+ * 			seeds the average.
+ */
+class ExponentialMovingAverage : public SampleFilter {
+public:
+	/*
+	 * 	@params - newAlpha - weight of each new sample, in (0, 1].
+	 * 	@throws - std::runtime_error if newAlpha is out of range.
+	 */
+	ExponentialMovingAverage(double newAlpha);
+
+	double filter(double sample);
+	void reset();
+
+private:
+	double alpha;
+	double average;
+	bool seeded;
+};
+
+/*
+ * 	RateOfChangeRejector - drops any sample that differs from the last accepted one by more than maxStep and repeats
+ * 			the last accepted value instead.  After maxRejections rejections in a row the new level is taken as real
+ * 			(e.g. strike water going in) and accepted.
+ */
+class RateOfChangeRejector : public SampleFilter {
+public:
+	/*
+	 * 	@params - newMaxStep - largest believable change between two samples, in the samples' unit.
+	 * 			- newMaxRejections - how many samples in a row may be rejected before the new level is accepted.
+	 */
+	RateOfChangeRejector(double newMaxStep, unsigned int newMaxRejections);
+
+	double filter(double sample);
+	void reset();
+
+	/*
+	 * 	getRejectedCount() - returns how many samples have been rejected since construction or reset().
+	 */
+	unsigned long getRejectedCount() const;
+
+private:
+	double maxStep;
+	unsigned int maxRejections;
+	double lastAccepted;
+	bool seeded;
+	unsigned int consecutiveRejections;
+	unsigned long rejectedCount;
+};
+
+/*
+ * 	FilterChain - runs a sample through up to MAX_STAGES filters in the order they were appended.  The chain does not
+ * 			own its stages.
+ */
+class FilterChain : public SampleFilter {
+public:
+	static const unsigned int MAX_STAGES = 8;
+
+	FilterChain();
+
+	/*
+	 * 	append() - adds stage to the end of the chain.
+	 * 	@throws - std::runtime_error if the chain already has MAX_STAGES stages.
+	 */
+	void append(SampleFilter &stage);
+
+	double filter(double sample);
+	void reset();
+
+private:
+	SampleFilter *stages[MAX_STAGES];
+	unsigned int stageCount;
+};
+
+#endif /* SAMPLEFILTER_H_ */
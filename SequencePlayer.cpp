@@ -0,0 +1,129 @@
+/*
+ * SequencePlayer.cpp - implementation file for SequencePlayer.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#include "SequencePlayer.h"
+
+namespace {
+	// Time between start() and the schedule's time zero, so the thread is up and running when the first step is due.
+	const uint64_t START_DELAY_NS = 1000000;
+
+	// Longest single sleep, so stop() never waits long for the thread.
+	const uint64_t MAX_SLEEP_NS = 100000000;
+}
+
+SequencePlayer::SequencePlayer(const std::vector<Step> &newSteps, uint64_t newSpinNanoseconds) :
+	steps(newSteps), errors(newSteps.size(), 0), played(0), spinNanoseconds(newSpinNanoseconds), startTime(0),
+	playing(false), stopRequested(false)
+{
+	// Make sure the schedule makes sense before we ever play it.
+	for (size_t i = 0; i < steps.size(); i++) {
+		if (i > 0 && steps[i].time < steps[i - 1].time) {
+			throw std::runtime_error("Sequence steps are out of order.");
+		}
+
+		if (steps[i].setMask & steps[i].clearMask) {
+			throw std::runtime_error("Sequence step both sets and clears a pin.");
+		}
+	}
+}
+
+SequencePlayer::~SequencePlayer() {
+	stop();
+}
+
+void SequencePlayer::start() {
+	if (playing.load()) {
+		throw std::runtime_error("Sequence is already playing.");
+	}
+
+	// The last play may have finished without anyone waiting for it
+	wait();
+
+	played.store(0);
+	stopRequested.store(false);
+	playing.store(true);
+	startTime = now() + START_DELAY_NS;
+
+	player = std::thread(&SequencePlayer::play, this);
+}
+
+void SequencePlayer::stop() {
+	stopRequested.store(true);
+	wait();
+}
+
+void SequencePlayer::wait() {
+	if (player.joinable()) {
+		player.join();
+	}
+}
+
+bool SequencePlayer::isPlaying() const {
+	return playing.load();
+}
+
+std::vector<int64_t> SequencePlayer::getEdgeErrors() const {
+	return std::vector<int64_t>(errors.begin(), errors.begin() + played.load(std::memory_order_acquire));
+}
+
+void SequencePlayer::play() {
+	// By default the kernel may wake a sleeping thread up to 50us late to batch timers, which would eat the whole
+	// busy-wait margin.  Ask for the tightest wake ups it will give us.
+	prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+
+	for (size_t i = 0; i < steps.size(); i++) {
+		uint64_t deadline = startTime + steps[i].time;
+		if (!waitUntil(deadline)) {
+			break;
+		}
+
+		// Write the edge, noting the time just before the register writes
+		uint64_t actual = now();
+		if (steps[i].setMask) {
+			gpioPin::setBank(steps[i].setMask);
+		}
+		if (steps[i].clearMask) {
+			gpioPin::clearBank(steps[i].clearMask);
+		}
+
+		errors[i] = (int64_t)(actual - deadline);
+		played.store(i + 1, std::memory_order_release);
+		BREW_TRACE_INSTANT("sequence edge", i, (int32_t)errors[i]);
+	}
+
+	playing.store(false);
+}
+
+bool SequencePlayer::waitUntil(uint64_t deadline) {
+	// Sleep until spinNanoseconds before the deadline, waking up now and then to see if we should stop
+	while (true) {
+		if (stopRequested.load(std::memory_order_relaxed)) {
+			return false;
+		}
+
+		uint64_t current = now();
+		if (current + spinNanoseconds >= deadline) {
+			break;
+		}
+
+		uint64_t wake = deadline - spinNanoseconds;
+		if (wake - current > MAX_SLEEP_NS) {
+			wake = current + MAX_SLEEP_NS;
+		}
+
+		struct timespec ts;
+		ts.tv_sec = wake / 1000000000ULL;
+		ts.tv_nsec = wake % 1000000000ULL;
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+	}
+
+	// Busy-wait the last stretch, sleeping can't hit a deadline this closely
+	while (now() < deadline) {
+	}
+
+	return true;
+}
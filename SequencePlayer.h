@@ -0,0 +1,130 @@
+/*
+ * SequencePlayer.h - plays a precompiled schedule of output changes (pump, valves, heater) on its own thread with
+ * 			tight timing.  Each Step sets and clears a mask of pins with single gpioPin bank writes at an absolute
+ * 			deadline measured from start(), so timing errors don't add up from step to step the way On()/Off() and
+ * 			sleeps do.  The thread sleeps until shortly before each deadline and busy-waits the rest of the way.
+ *
+ * 			The time each edge was actually written is recorded, and getEdgeErrors() reports how far each one was
+ * 			from its deadline.  Running the program under SCHED_FIFO (e.g. chrt -f 50) keeps the errors small.
+ *
+ * 			Example usage:	- gpioPin pump(PUMP_PIN, gpioPin::OUT);
+ * 							- std::vector<SequencePlayer::Step> steps = {{0, 1 << PUMP_PIN, 0},
+ * 																		{5000000000ULL, 0, 1 << PUMP_PIN}};
+ * 							- SequencePlayer player(steps);
+ * 							- player.start();
+ * 							- player.wait();
+ *
+ * 	Requires C++11 (-std=c++0x command line option) and -pthread
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#ifndef SEQUENCEPLAYER_H_
+#define SEQUENCEPLAYER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <time.h>
+#include <sys/prctl.h>
+#include "gpioPin.h"
+#include "EventTracer.h"
+
+class SequencePlayer {
+public:
+	/*
+	 * 	Step - at time nanoseconds after start(), set the pins in setMask and clear the pins in clearMask.  Bit n
+	 * 			is GPIO n.
+	 */
+	struct Step {
+		uint64_t time;
+		uint32_t setMask;
+		uint32_t clearMask;
+	};
+
+	/*
+	 * 	The schedule is copied, so all allocation happens here and not while playing.
+	 * 	@params - newSteps - the schedule, in time order.
+	 * 			- newSpinNanoseconds - how long before each deadline to stop sleeping and start busy-waiting.
+	 * 	@throws - std::runtime_error if the steps are out of order or a step both sets and clears a pin.
+	 */
+	SequencePlayer(const std::vector<Step> &newSteps, uint64_t newSpinNanoseconds = 50000);
+
+	/*
+	 * 	The destructor stops the sequence if it is still playing.
+	 */
+	virtual ~SequencePlayer();
+
+	/*
+	 * 	start() - starts playing the schedule on a new thread.  Step times count from a moment just after the call.
+	 * 			Once a play has finished, start() may be called again to replay it.
+	 * 	@pre - the pins used must be set as outputs with gpioPin.
+	 * 	@throws - std::runtime_error if the sequence is already playing.
+	 */
+	void start();
+
+	/*
+	 * 	stop() - abandons the rest of the schedule and waits for the thread to finish.  Pins are left as they are.
+	 */
+	void stop();
+
+	/*
+	 * 	wait() - waits for the schedule to finish playing.
+	 */
+	void wait();
+
+	/*
+	 * 	isPlaying() - returns true from start() until the last step has been played or stop() is called.
+	 */
+	bool isPlaying() const;
+
+	/*
+	 * 	getEdgeErrors() - returns, for each step played so far, how late (positive) or early (negative) it was
+	 * 			written in nanoseconds.
+	 */
+	std::vector<int64_t> getEdgeErrors() const;
+
+private:
+	/*
+	 * 	steps - the schedule.
+	 */
+	std::vector<Step> steps;
+
+	/*
+	 * 	errors - actual - deadline for each step played, in nanoseconds.  Sized to steps up front.
+	 */
+	std::vector<int64_t> errors;
+
+	/*
+	 * 	played - how many steps have been played.  errors[0..played) are valid.
+	 */
+	std::atomic<unsigned int> played;
+
+	/*
+	 * 	spinNanoseconds - how long before each deadline sleeping stops and busy-waiting starts.
+	 */
+	uint64_t spinNanoseconds;
+
+	/*
+	 * 	startTime - the CLOCK_MONOTONIC time step times count from.
+	 */
+	uint64_t startTime;
+
+	std::atomic<bool> playing;
+	std::atomic<bool> stopRequested;
+	std::thread player;
+
+	void play();	// Thread body, plays the steps in order.
+	bool waitUntil(uint64_t deadline);	// Sleeps then spins until deadline.  Returns false if stop() was called.
+
+	static uint64_t now() {
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	}
+};
+
+#endif /* SEQUENCEPLAYER_H_ */
@@ -0,0 +1,189 @@
+/*
+ * SimulatedKettle.cpp - implementation file for SimulatedKettle.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#include "SimulatedKettle.h"
+
+namespace {
+	// Specific heat of water, J/(kg K).  A litre is taken as a kilogram.
+	const double WATER_HEAT_CAPACITY = 4186.0;
+
+	const double STEP_SECONDS = SimulatedKettle::STEP_USECS * 1e-6;
+}
+
+static_assert(HE_PIN < 32 && PUMP_PIN < 32, "SimulatedKettle only plays GPIO bank 0.");
+
+SimulatedKettle::Parameters::Parameters() :
+	waterLitres(20.0), heaterFraction(0.2), heaterWatts(2000.0), pumpLitresPerMinute(8.0), convectionWattsPerK(5.0),
+	lossWattsPerK(3.0), ambientCelsius(20.0), boilingCelsius(100.0), probeSeconds(4.0)
+{
+}
+
+SimulatedKettle::SimulatedKettle(const Parameters &newParameters) :
+	parameters(newParameters), pinSource(MANUAL), heaterOn(false), pumpOn(false), heaterWaterTemperature(0),
+	bulkWaterTemperature(0), probeTemperature(0), heaterEnergy(0), heaterHeatCapacity(0), bulkHeatCapacity(0),
+	pendingMicroseconds(0)
+{
+	if (!(parameters.waterLitres > 0) || !(parameters.heaterFraction > 0 && parameters.heaterFraction < 1)) {
+		throw std::runtime_error("Kettle needs water on both sides of the model.");
+	}
+
+	if (parameters.heaterWatts < 0 || parameters.pumpLitresPerMinute < 0 || parameters.convectionWattsPerK < 0 ||
+			parameters.lossWattsPerK < 0 || !(parameters.probeSeconds > 0)) {
+		throw std::runtime_error("Kettle parameters can't be negative.");
+	}
+
+	heaterHeatCapacity = parameters.waterLitres * parameters.heaterFraction * WATER_HEAT_CAPACITY;
+	bulkHeatCapacity = parameters.waterLitres * (1.0 - parameters.heaterFraction) * WATER_HEAT_CAPACITY;
+
+	// The model is stepped with Euler's method, which blows up if a lump could swing past equilibrium in one step
+	double exchange = parameters.convectionWattsPerK + parameters.pumpLitresPerMinute / 60.0 * WATER_HEAT_CAPACITY;
+	double smallest = (heaterHeatCapacity < bulkHeatCapacity) ? heaterHeatCapacity : bulkHeatCapacity;
+	if ((exchange + parameters.lossWattsPerK) * STEP_SECONDS >= smallest) {
+		throw std::runtime_error("Kettle is too small for the pump flow to simulate.");
+	}
+
+	setWaterTemperature(parameters.ambientCelsius);
+}
+
+SimulatedKettle::~SimulatedKettle() {
+}
+
+void SimulatedKettle::wait(unsigned int microseconds) {
+	// Let the chips' time pass up to each step boundary, then step the model, so conversions finishing part way
+	// through a wait see the temperature of that moment
+	while (microseconds > 0) {
+		unsigned int chunk = STEP_USECS - pendingMicroseconds;
+		if (chunk > microseconds) {
+			chunk = microseconds;
+		}
+
+		SimulatedMax31865::wait(chunk);
+		pendingMicroseconds += chunk;
+		microseconds -= chunk;
+
+		if (pendingMicroseconds == STEP_USECS) {
+			step();
+			pendingMicroseconds = 0;
+		}
+	}
+}
+
+void SimulatedKettle::setPinSource(PIN_SOURCE source) {
+	if (source == GPIO_REGISTERS) {
+		gpioPin::mapRegisters();
+	}
+
+	pinSource = source;
+}
+
+SimulatedKettle::PIN_SOURCE SimulatedKettle::getPinSource() const {
+	return pinSource;
+}
+
+void SimulatedKettle::setHeater(bool on) {
+	heaterOn = on;
+}
+
+void SimulatedKettle::setPump(bool on) {
+	pumpOn = on;
+}
+
+bool SimulatedKettle::isHeaterOn() const {
+	return heaterOn;
+}
+
+bool SimulatedKettle::isPumpOn() const {
+	return pumpOn;
+}
+
+void SimulatedKettle::setWaterTemperature(double celsius) {
+	heaterWaterTemperature = celsius;
+	bulkWaterTemperature = celsius;
+	probeTemperature = celsius;
+
+	updateChips();
+}
+
+double SimulatedKettle::getWaterTemperature() const {
+	return bulkWaterTemperature;
+}
+
+double SimulatedKettle::getHeaterWaterTemperature() const {
+	return heaterWaterTemperature;
+}
+
+double SimulatedKettle::getProbeTemperature() const {
+	return probeTemperature;
+}
+
+double SimulatedKettle::getHeaterEnergy() const {
+	return heaterEnergy;
+}
+
+void SimulatedKettle::step() {
+	if (pinSource == GPIO_REGISTERS) {
+		readPins();
+	}
+
+	double heaterPower = heaterOn ? parameters.heaterWatts : 0.0;
+	heaterEnergy += heaterPower * STEP_SECONDS;
+
+	// Heat flowing from the element's lump to the bulk, and from each to the room.  Losses are shared out by volume.
+	double exchange = parameters.convectionWattsPerK;
+	if (pumpOn) {
+		exchange += parameters.pumpLitresPerMinute / 60.0 * WATER_HEAT_CAPACITY;
+	}
+	double transfer = exchange * (heaterWaterTemperature - bulkWaterTemperature);
+	double heaterLoss = parameters.lossWattsPerK * parameters.heaterFraction *
+			(heaterWaterTemperature - parameters.ambientCelsius);
+	double bulkLoss = parameters.lossWattsPerK * (1.0 - parameters.heaterFraction) *
+			(bulkWaterTemperature - parameters.ambientCelsius);
+
+	heaterWaterTemperature += (heaterPower - transfer - heaterLoss) * STEP_SECONDS / heaterHeatCapacity;
+	bulkWaterTemperature += (transfer - bulkLoss) * STEP_SECONDS / bulkHeatCapacity;
+
+	// Anything more just boils water off
+	if (heaterWaterTemperature > parameters.boilingCelsius) {
+		heaterWaterTemperature = parameters.boilingCelsius;
+	}
+	if (bulkWaterTemperature > parameters.boilingCelsius) {
+		bulkWaterTemperature = parameters.boilingCelsius;
+	}
+
+	// The probe lags the bulk water
+	double lag = STEP_SECONDS / parameters.probeSeconds;
+	if (lag > 1.0) {
+		lag = 1.0;
+	}
+	probeTemperature += (bulkWaterTemperature - probeTemperature) * lag;
+
+	updateChips();
+}
+
+void SimulatedKettle::readPins() {
+	volatile uint32_t *registers = gpioPin::registers();
+	if (registers == NULL) {
+		throw std::runtime_error("GPIO registers are not mapped.");
+	}
+
+	// Apply the set & clear writes since the last step to the level register, as the GPIO block would
+	uint32_t set = registers[gpioPin::SET_OFFSET];
+	uint32_t clear = registers[gpioPin::CLR_OFFSET];
+	uint32_t level = (registers[gpioPin::LVL_OFFSET] | set) & ~clear;
+
+	registers[gpioPin::SET_OFFSET] = 0;
+	registers[gpioPin::CLR_OFFSET] = 0;
+	registers[gpioPin::LVL_OFFSET] = level;
+
+	heaterOn = (level & (1u << HE_PIN)) != 0;
+	pumpOn = (level & (1u << PUMP_PIN)) != 0;
+}
+
+void SimulatedKettle::updateChips() {
+	setTemperature(SPI_CE0, probeTemperature);
+	setTemperature(SPI_CE1, heaterWaterTemperature);
+}
@@ -0,0 +1,143 @@
+/*
+ * SimulatedKettle.h - a thermal model of the kettle behind the simulated MAX31865s, for closed loop testing
+ * 			without the rig.  The water is split into two well mixed lumps: the water around the heating element
+ * 			and the bulk of the kettle.  The element heats its lump; the pump circulates water between the two,
+ * 			and without it only natural convection does; both lose heat to the room.  The probe sits in a thermowell
+ * 			in the bulk and follows it with a first order lag.  Water does not go past the boiling point.
+ *
+ * 			SPI_CE0 reads the kettle probe and SPI_CE1 reads the water at the element.  The model steps every
+ * 			STEP_USECS of simulated time, whenever the probe waits or the controller calls wait(), so it runs as fast
+ * 			as the host allows - hours of brewing in seconds.
+ *
+ * 			The heater and pump follow HE_PIN and PUMP_PIN.  With PIN_SOURCE GPIO_REGISTERS they are read from
+ * 			gpioPin's registers at every step, so a controller can drive them with gpioPin, StaticGpioPin or
+ * 			SequencePlayer.  That only makes sense when the registers are a file (see gpioPin::setSystemRoot()):
+ * 			the model plays the GPIO block, moving set & clear writes into the level register and zeroing them.
+ * 			A pin both set and cleared within one step ends up cleared.  With PIN_SOURCE MANUAL (the default) they
+ * 			follow setHeater() and setPump().
+ *
+ * 			Example usage:	- SimulatedKettle kettle;
+ * 							- TemperatureProbe probe(kettle, SPI_CE0, TemperatureProbe::CELSIUS);
+ * 							- kettle.setHeater(true);
+ * 							- kettle.wait(60000000);	// one simulated minute
+ * 							- probe.getTemperature();
+ *
+ * 	Requires C++11 (-std=c++0x command line option)
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#ifndef SIMULATEDKETTLE_H_
+#define SIMULATEDKETTLE_H_
+
+#include <cstdint>
+#include "SimulatedMax31865.h"
+#include "PinAssignments.h"
+#include "gpioPin.h"
+
+class SimulatedKettle : public SimulatedMax31865 {
+public:
+	/*
+	 * 	Parameters - the physical kettle.  The defaults are a 20L kettle with a 2kW element and a small pump.
+	 */
+	struct Parameters {
+		double waterLitres;			// Total water in the kettle.
+		double heaterFraction;		// Share of the water in the lump around the element, 0-1.
+		double heaterWatts;			// Element power when on.
+		double pumpLitresPerMinute;	// Flow between the lumps with the pump on.
+		double convectionWattsPerK;	// Heat exchanged between the lumps by natural convection.
+		double lossWattsPerK;		// Heat lost from the whole kettle to the room.
+		double ambientCelsius;		// Room temperature.
+		double boilingCelsius;		// Temperature the water can't go past.
+		double probeSeconds;		// Time constant of the probe and thermowell.
+
+		Parameters();
+	};
+
+	/*
+	 * 	PIN_SOURCE - where the heater and pump states come from.
+	 */
+	enum PIN_SOURCE {MANUAL, GPIO_REGISTERS};
+
+	/*
+	 * 	STEP_USECS - simulated microseconds per model step.
+	 */
+	static const unsigned int STEP_USECS = 10000;
+
+	/*
+	 * 	All the water starts at the ambient temperature.
+	 * 	@throws - std::runtime_error if the parameters are not physical.
+	 */
+	SimulatedKettle(const Parameters &newParameters = Parameters());
+	virtual ~SimulatedKettle();
+
+	/*
+	 * 	wait() - lets microseconds of simulated time pass, stepping the model.
+	 */
+	void wait(unsigned int microseconds);
+
+	/*
+	 * 	setPinSource() - chooses where the heater and pump states come from.  GPIO_REGISTERS maps the registers if
+	 * 			gpioPin hasn't yet.
+	 * 	@throws - std::runtime_error if the registers can't be mapped.
+	 */
+	void setPinSource(PIN_SOURCE source);
+	PIN_SOURCE getPinSource() const;
+
+	/*
+	 * 	setHeater() / setPump() - turn the element and pump on or off with PIN_SOURCE MANUAL.
+	 */
+	void setHeater(bool on);
+	void setPump(bool on);
+	bool isHeaterOn() const;
+	bool isPumpOn() const;
+
+	/*
+	 * 	setWaterTemperature() - sets all the water, and the probe, to celsius.
+	 */
+	void setWaterTemperature(double celsius);
+
+	/*
+	 * 	getWaterTemperature() - the bulk water temperature in celsius.
+	 */
+	double getWaterTemperature() const;
+
+	/*
+	 * 	getHeaterWaterTemperature() - the temperature of the water around the element in celsius.
+	 */
+	double getHeaterWaterTemperature() const;
+
+	/*
+	 * 	getProbeTemperature() - the temperature the probe itself is at in celsius.
+	 */
+	double getProbeTemperature() const;
+
+	/*
+	 * 	getHeaterEnergy() - energy the element has put in since construction, in joules.
+	 */
+	double getHeaterEnergy() const;
+
+private:
+	Parameters parameters;
+	PIN_SOURCE pinSource;
+
+	bool heaterOn;
+	bool pumpOn;
+
+	double heaterWaterTemperature;
+	double bulkWaterTemperature;
+	double probeTemperature;
+	double heaterEnergy;
+
+	double heaterHeatCapacity;	// J/K of the water around the element.
+	double bulkHeatCapacity;	// J/K of the bulk water.
+
+	unsigned int pendingMicroseconds;	// Simulated time waited but not yet stepped.
+
+	void step();	// Advances the model STEP_USECS.
+	void readPins();	// Plays the GPIO block for HE_PIN and PUMP_PIN.
+	void updateChips();	// Hands the temperatures to the simulated MAX31865s.
+};
+
+#endif /* SIMULATEDKETTLE_H_ */
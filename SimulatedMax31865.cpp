@@ -0,0 +1,216 @@
+/*
+ * SimulatedMax31865.cpp - implementation file for SimulatedMax31865.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#include "SimulatedMax31865.h"
+
+constexpr double SimulatedMax31865::REFERENCE_OHMS;
+
+namespace {
+	// Configuration register bits, see TemperatureProbe::CONFIG_BITS
+	const unsigned char CONFIG_AUTO = 0x40;
+	const unsigned char CONFIG_ONE_SHOT = 0x20;
+	const unsigned char CONFIG_FAULT_CLEAR = 0x02;
+	const unsigned char CONFIG_50HZ = 0x01;
+
+	// Register addresses
+	const unsigned char REG_CONFIG = 0x00;
+	const unsigned char REG_RTD_MSB = 0x01;
+	const unsigned char REG_RTD_LSB = 0x02;
+	const unsigned char REG_FAULT = 0x07;
+	const unsigned char REG_COUNT = 8;
+	const unsigned char WRITE_BIT = 0x80;
+}
+
+SimulatedMax31865::SimulatedMax31865() :
+	clock(0), selected(&chips[0]), noise(0), generator(31865), gaussian(0.0, 1.0)
+{
+	for (unsigned int i = 0; i < 2; i++) {
+		Chip &c = chips[i];
+
+		// Power on register values: thresholds wide open, everything else 0
+		for (unsigned int r = 0; r < REG_COUNT; r++) {
+			c.registers[r] = 0;
+		}
+		c.registers[0x03] = 0xFF;
+		c.registers[0x04] = 0xFF;
+
+		c.resistance = temperatureToResistance(0.0);
+		c.pendingFault = 0;
+		c.converting = false;
+		c.readyTime = 0;
+		c.autoStart = 0;
+		c.ready = false;
+		c.conversions = 0;
+	}
+}
+
+SimulatedMax31865::~SimulatedMax31865() {
+}
+
+void SimulatedMax31865::transfer(unsigned char *data, int length) {
+	Chip &c = *selected;
+	update(c);
+
+	if (length < 1) {
+		return;
+	}
+
+	// The first byte is the address, following bytes read or write consecutive registers.  Nothing useful
+	// comes back while the address or write data is clocked out.
+	unsigned char address = data[0];
+	data[0] = 0;
+
+	for (int i = 1; i < length; i++) {
+		unsigned char reg = ((address & ~WRITE_BIT) + i - 1) % REG_COUNT;
+
+		if (address & WRITE_BIT) {
+			writeRegister(c, reg, data[i]);
+			data[i] = 0;
+		} else {
+			data[i] = c.registers[reg];
+
+			// Reading the RTD registers releases DRDY
+			if (reg == REG_RTD_LSB) {
+				c.ready = false;
+			}
+		}
+	}
+}
+
+bool SimulatedMax31865::dataReady() {
+	update(*selected);
+	return selected->ready;
+}
+
+void SimulatedMax31865::selectChip(unsigned int chipSelect) {
+	selected = &chip(chipSelect);
+}
+
+void SimulatedMax31865::wait(unsigned int microseconds) {
+	clock += microseconds;
+}
+
+void SimulatedMax31865::setTemperature(unsigned int chipSelect, double celsius) {
+	chip(chipSelect).resistance = temperatureToResistance(celsius);
+}
+
+void SimulatedMax31865::setResistance(unsigned int chipSelect, double ohms) {
+	chip(chipSelect).resistance = ohms;
+}
+
+void SimulatedMax31865::setNoise(double codes) {
+	noise = codes;
+}
+
+void SimulatedMax31865::setFault(unsigned int chipSelect, unsigned char faultBits) {
+	chip(chipSelect).pendingFault |= faultBits;
+}
+
+unsigned char SimulatedMax31865::getConfig(unsigned int chipSelect) const {
+	return const_cast<SimulatedMax31865 *>(this)->chip(chipSelect).registers[REG_CONFIG];
+}
+
+unsigned long SimulatedMax31865::getConversions(unsigned int chipSelect) const {
+	return const_cast<SimulatedMax31865 *>(this)->chip(chipSelect).conversions;
+}
+
+uint64_t SimulatedMax31865::now() const {
+	return clock;
+}
+
+double SimulatedMax31865::temperatureToResistance(double celsius) {
+	// R = R0 * (1 + A*T + B*T^2), the inverse of TemperatureProbe's conversion
+	const double R0 = 100.0;
+	const double A = 3.9083e-3;
+	const double B = -5.775e-7;
+
+	return R0 * (1.0 + A * celsius + B * celsius * celsius);
+}
+
+SimulatedMax31865::Chip &SimulatedMax31865::chip(unsigned int chipSelect) {
+	if (chipSelect == SPI_CE0) {
+		return chips[0];
+	} else if (chipSelect == SPI_CE1) {
+		return chips[1];
+	}
+
+	throw std::runtime_error("Unknown chip select for simulated MAX31865.");
+}
+
+void SimulatedMax31865::update(Chip &c) {
+	if (c.registers[REG_CONFIG] & CONFIG_AUTO) {
+		// Automatic conversions finish every conversionTime from when auto was turned on
+		if (clock >= c.readyTime) {
+			convert(c);
+
+			uint64_t period = conversionTime(c);
+			c.readyTime = c.autoStart + ((clock - c.autoStart) / period + 1) * period;
+		}
+	} else if (c.converting && clock >= c.readyTime) {
+		convert(c);
+		c.converting = false;
+	}
+}
+
+void SimulatedMax31865::writeRegister(Chip &c, unsigned char address, unsigned char value) {
+	if (address == REG_CONFIG) {
+		unsigned char old = c.registers[REG_CONFIG];
+
+		// One-shot and fault clear never stay set
+		c.registers[REG_CONFIG] = value & ~(CONFIG_ONE_SHOT | CONFIG_FAULT_CLEAR);
+
+		if (value & CONFIG_FAULT_CLEAR) {
+			c.registers[REG_FAULT] = 0;
+			c.registers[REG_RTD_LSB] &= ~0x01;
+			c.pendingFault = 0;
+		}
+
+		if ((value & CONFIG_AUTO) && !(old & CONFIG_AUTO)) {
+			c.autoStart = clock;
+			c.readyTime = clock + conversionTime(c);
+			c.ready = false;
+		} else if ((value & CONFIG_ONE_SHOT) && !(value & CONFIG_AUTO)) {
+			c.converting = true;
+			c.readyTime = clock + conversionTime(c);
+			c.ready = false;
+		}
+	} else if (address >= 0x03 && address <= 0x06) {
+		// Fault thresholds are the only other writable registers
+		c.registers[address] = value;
+	}
+}
+
+void SimulatedMax31865::convert(Chip &c) {
+	double code = c.resistance * 32768.0 / REFERENCE_OHMS;
+	if (noise > 0) {
+		code += gaussian(generator) * noise;
+	}
+
+	int32_t adcCode = (int32_t)(code + 0.5);
+	if (adcCode < 0) {
+		adcCode = 0;
+	} else if (adcCode > 32767) {
+		adcCode = 32767;
+	}
+
+	c.registers[REG_FAULT] |= c.pendingFault;
+	unsigned char faultBit = (c.registers[REG_FAULT] != 0) ? 0x01 : 0x00;
+
+	c.registers[REG_RTD_MSB] = (unsigned char)(adcCode >> 7);
+	c.registers[REG_RTD_LSB] = (unsigned char)((adcCode << 1) & 0xFE) | faultBit;
+	c.ready = true;
+	c.conversions++;
+}
+
+uint64_t SimulatedMax31865::conversionTime(const Chip &c) const {
+	bool filter50Hz = (c.registers[REG_CONFIG] & CONFIG_50HZ) != 0;
+
+	if (c.registers[REG_CONFIG] & CONFIG_AUTO) {
+		return filter50Hz ? 20000 : 16667;
+	}
+	return filter50Hz ? 62500 : 52000;
+}
@@ -0,0 +1,120 @@
+/*
+ * SimulatedMax31865.h - a software MAX31865 on each of the two chip selects, speaking the chip's register protocol
+ * 			over the SpiBus interface so TemperatureProbe can run without hardware.  Time is simulated: wait()
+ * 			advances the bus's own clock instead of sleeping, so conversions "take" their real 52-62.5ms (one-shot)
+ * 			or 16.7-20ms (continuous) without anyone waiting for them.
+ *
+ * 			Each chip converts the temperature or resistance last set for it, optionally with gaussian noise, and
+ * 			can be given fault bits to report.  wait() is virtual so a plant model can derive from this class and
+ * 			advance its own state along with the clock.
+ *
+ * 			Example usage:	- SimulatedMax31865 chips;
+ * 							- chips.setTemperature(SPI_CE0, 65.0);
+ * 							- TemperatureProbe probe(chips, SPI_CE0, TemperatureProbe::CELSIUS);
+ * 							- probe.getTemperature();	// ~65.0
+ *
+ * 	Requires C++11 (-std=c++0x command line option)
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#ifndef SIMULATEDMAX31865_H_
+#define SIMULATEDMAX31865_H_
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include "SpiBus.h"
+#include "PinAssignments.h"
+
+class SimulatedMax31865 : public SpiBus {
+public:
+	/*
+	 * 	REFERENCE_OHMS - the reference resistor TemperatureProbe's conversion assumes.
+	 */
+	static constexpr double REFERENCE_OHMS = 385.0;
+
+	SimulatedMax31865();
+	virtual ~SimulatedMax31865();
+
+	// SpiBus
+	void transfer(unsigned char *data, int length);
+	bool dataReady();
+	void selectChip(unsigned int chipSelect);
+	void wait(unsigned int microseconds);
+	uint64_t now() const;	// The simulated time in microseconds since construction.
+
+	/*
+	 * 	setTemperature() - sets the RTD on chipSelect to a PT100 at celsius.
+	 */
+	void setTemperature(unsigned int chipSelect, double celsius);
+
+	/*
+	 * 	setResistance() - sets the RTD on chipSelect to ohms.
+	 */
+	void setResistance(unsigned int chipSelect, double ohms);
+
+	/*
+	 * 	setNoise() - adds gaussian noise with a standard deviation of codes ADC codes to every conversion.
+	 */
+	void setNoise(double codes);
+
+	/*
+	 * 	setFault() - makes chipSelect report faultBits (TemperatureProbe::FAULT_BITS) from its next conversion on,
+	 * 			until a fault clear is written.  0 clears nothing by itself.
+	 */
+	void setFault(unsigned int chipSelect, unsigned char faultBits);
+
+	/*
+	 * 	getConfig() - returns the configuration register of chipSelect.
+	 */
+	unsigned char getConfig(unsigned int chipSelect) const;
+
+	/*
+	 * 	getConversions() - returns how many conversions chipSelect has finished.
+	 */
+	unsigned long getConversions(unsigned int chipSelect) const;
+
+	/*
+	 * 	temperatureToResistance() - Callendar-Van Dusen resistance of a PT100 at celsius (the same curve
+	 * 			TemperatureProbe inverts).
+	 */
+	static double temperatureToResistance(double celsius);
+
+protected:
+	/*
+	 * 	clock - simulated time in microseconds.
+	 */
+	uint64_t clock;
+
+private:
+	/*
+	 * 	Chip - one MAX31865.  registers[] is the chip's register file, addresses 0x00-0x07.
+	 */
+	struct Chip {
+		unsigned char registers[8];
+		double resistance;
+		unsigned char pendingFault;
+		bool converting;		// a one-shot conversion is running
+		uint64_t readyTime;		// when the running (or next automatic) conversion finishes
+		uint64_t autoStart;		// when automatic conversion was turned on
+		bool ready;				// DRDY is low
+		unsigned long conversions;
+	};
+
+	Chip chips[2];
+	Chip *selected;
+
+	double noise;
+	std::mt19937 generator;
+	std::normal_distribution<double> gaussian;
+
+	Chip &chip(unsigned int chipSelect);	// @throws - std::runtime_error for an unknown chip select
+	void update(Chip &c);	// Finishes any conversion due by now.
+	void writeRegister(Chip &c, unsigned char address, unsigned char value);
+	void convert(Chip &c);	// Latches a new reading into the RTD registers and pulls DRDY low.
+	uint64_t conversionTime(const Chip &c) const;	// Length of one conversion for the chip's settings.
+};
+
+#endif /* SIMULATEDMAX31865_H_ */
@@ -0,0 +1,50 @@
+/*
+ * SpiBus.h - interface TemperatureProbe can talk to a MAX31865 through instead of spidev and the DRDY pin, e.g. a
+ * 			simulated chip for benchmarks and hardware-free testing (see SimulatedMax31865.h).
+ *
+ * 	Requires C++11 (-std=c++0x command line option)
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#ifndef SPIBUS_H_
+#define SPIBUS_H_
+
+#include <cstdint>
+
+class SpiBus {
+public:
+	virtual ~SpiBus() {}
+
+	/*
+	 * 	transfer() - clocks length bytes out of data to the selected chip, replacing each with the byte clocked in.
+	 * 	@throws - std::runtime_error
+	 */
+	virtual void transfer(unsigned char *data, int length) = 0;
+
+	/*
+	 * 	dataReady() - returns true once the selected chip has pulled DRDY low.
+	 */
+	virtual bool dataReady() = 0;
+
+	/*
+	 * 	selectChip() - chooses which chip select following transfers use.  Values are defined in PinAssignments.h.
+	 * 	@throws - std::runtime_error
+	 */
+	virtual void selectChip(unsigned int chipSelect) = 0;
+
+	/*
+	 * 	wait() - lets microseconds pass, e.g. for the bias to settle or between DRDY polls.  A simulated bus may
+	 * 			just advance its own clock.
+	 */
+	virtual void wait(unsigned int microseconds) = 0;
+
+	/*
+	 * 	now() - the bus's clock in microseconds, which wait() advances.  Used to time readings, so a simulated bus
+	 * 			reports its simulated time.
+	 */
+	virtual uint64_t now() const = 0;
+};
+
+#endif /* SPIBUS_H_ */
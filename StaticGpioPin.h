@@ -0,0 +1,101 @@
+/*
+ * 	StaticGpioPin.h - a GPIO pin whose number and direction are fixed at compile time.  Register offsets and the pin's
+ * 			bit mask are constexpr, so On() and Off() compile to one store to a precomputed register (plus loading
+ * 			the mapped register base, which is only known at run time).  They are not instrumented with
+ * 			LatencyHistogram or EventTracer for the same reason.  Use gpioPin when the pin is only known at run time.
+ *
+ * 			Output pins are checked at compile time against the SPI pins reserved in PinAssignments.h.
+ *
+ * 			Example usage:	- StaticGpioPin<PUMP_PIN> pump;
+ * 							- pump.On();
+ * 							- StaticGpioPin<DRDY_PIN, gpioPin::IN> drdy;
+ * 							- if (drdy.Value() == gpioPin::LOW) {...}
+ *
+ * 			@throws - std::runtime_error upon failure to initialize.
+ *
+ * 	Requires C++11 (-std=c++0x command line option)
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#ifndef STATICGPIOPIN_H_
+#define STATICGPIOPIN_H_
+
+#include <cstdint>
+#include "gpioPin.h"
+#include "PinAssignments.h"
+
+template<uint32_t PIN, gpioPin::DIRECTION DIR = gpioPin::OUT>
+class StaticGpioPin {
+	static_assert(PIN < GPIO_PIN_COUNT, "StaticGpioPin: not a BCM2835 GPIO pin.");
+	static_assert(DIR == gpioPin::IN || !isReservedPin(PIN), "StaticGpioPin: output pin conflicts with the SPI pins.");
+
+public:
+	/*
+	 * 	FSEL_OFFSET, FSEL_SHIFT - the function select register and bit position which set the pin's direction.
+	 */
+	static constexpr uint32_t FSEL_OFFSET = PIN / 10;
+	static constexpr uint32_t FSEL_SHIFT = (PIN % 10) * 3;
+
+	/*
+	 * 	SET_OFFSET, CLR_OFFSET, LVL_OFFSET - the set, clear and level registers for the pin's bank of 32.
+	 */
+	static constexpr uint32_t SET_OFFSET = gpioPin::SET_OFFSET + PIN / 32;
+	static constexpr uint32_t CLR_OFFSET = gpioPin::CLR_OFFSET + PIN / 32;
+	static constexpr uint32_t LVL_OFFSET = gpioPin::LVL_OFFSET + PIN / 32;
+
+	/*
+	 * 	MASK - the pin's bit in its bank's registers.
+	 */
+	static constexpr uint32_t MASK = 1u << (PIN % 32);
+
+	/*
+	 * 	The constructor maps the GPIO registers if needed and sets the pin's direction.
+	 * 	@throws - std::runtime_error if the registers can't be mapped.
+	 */
+	StaticGpioPin() {
+		gpioPin::mapRegisters();
+		volatile uint32_t *gpio = gpioPin::registers();
+
+		// Always set IN before OUT.  So set in, then out if needed.
+		gpioPin::barrier();
+		*(gpio + FSEL_OFFSET) &= ~(7u << FSEL_SHIFT);
+		if (DIR == gpioPin::OUT) {
+			*(gpio + FSEL_OFFSET) |= (1u << FSEL_SHIFT);
+		}
+		gpioPin::barrier();
+	}
+
+	/*
+	 * 	On() - Sets the pin to ON/HIGH.  Only available on output pins.
+	 * 	@post - the pin will be set ON/HIGH.
+	 */
+	void On() const {
+		static_assert(DIR == gpioPin::OUT, "StaticGpioPin: On() needs an output pin.");
+		*(gpioPin::registers() + SET_OFFSET) = MASK;
+	}
+
+	/*
+	 * 	Off() - Sets the pin to OFF/LOW.  Only available on output pins.
+	 * 	@post - the pin will be set OFF/LOW.
+	 */
+	void Off() const {
+		static_assert(DIR == gpioPin::OUT, "StaticGpioPin: Off() needs an output pin.");
+		*(gpioPin::registers() + CLR_OFFSET) = MASK;
+	}
+
+	/*
+	 * 	Value() - Returns the current value of the pin.
+	 * 	@return - the current value of the pin.
+	 */
+	gpioPin::VALUE Value() const {
+		gpioPin::barrier();
+		uint32_t level = *(gpioPin::registers() + LVL_OFFSET);
+		gpioPin::barrier();
+
+		return ((level & MASK) != 0) ? gpioPin::HIGH : gpioPin::LOW;
+	}
+};
+
+#endif /* STATICGPIOPIN_H_ */
@@ -8,8 +8,10 @@
 #include "TemperatureProbe.h"
 
 TemperatureProbe::TemperatureProbe(unsigned int newChipSelect, UNIT newUnit) :
-	temperature(0), currentUnit(newUnit), currentChipSelect(newChipSelect), mode(SPI_MODE_1),
-	bitsPerWord(8), speed(1000000), spifd(-1), spiDRDY(DRDY_PIN)
+	temperature(0), currentUnit(newUnit), currentChipSelect(newChipSelect), wireMode(THREE_WIRE),
+	noiseFilter(FILTER_60HZ), biasMode(BIAS_ALWAYS_ON), conversionMode(ONE_SHOT), oversampling(1),
+	sampleFilter(nullptr), writtenConfig(0), mode(SPI_MODE_1), bitsPerWord(8), speed(1000000), spifd(-1),
+	spiDRDY(new PinInput(DRDY_PIN)), bus(nullptr)
 {
 	// Using currentChipSelect, open the correct SPI device.
 	if (currentChipSelect == SPI_CE0) {
@@ -18,63 +20,86 @@ TemperatureProbe::TemperatureProbe(unsigned int newChipSelect, UNIT newUnit) :
 		spiOpen(std::string("/dev/spidev0.1"));
 	}
 
-	// Set-up the configuration register of the MAX31865, ready it for 1-shot conversion using 3-wire RTD, and
-	// clear the fault register
-	unsigned char initConfig[2] = {0x80, 0x92};
-	this->spiWriteRead(initConfig, 2);
+	initialize();
+}
 
-	// Delay to allow the RC network to settle 10ms
-	usleep(10000);
+TemperatureProbe::TemperatureProbe(SpiBus &newBus, unsigned int newChipSelect, UNIT newUnit) :
+	temperature(0), currentUnit(newUnit), currentChipSelect(newChipSelect), wireMode(THREE_WIRE),
+	noiseFilter(FILTER_60HZ), biasMode(BIAS_ALWAYS_ON), conversionMode(ONE_SHOT), oversampling(1),
+	sampleFilter(nullptr), writtenConfig(0), mode(SPI_MODE_1), bitsPerWord(8), speed(1000000), spifd(-1),
+	bus(&newBus)
+{
+	bus->selectChip(currentChipSelect);
+
+	initialize();
 }
 
 TemperatureProbe::~TemperatureProbe() {
-	spiClose();
+	if (bus == nullptr) {
+		spiClose();
+	}
 }
 
-double TemperatureProbe::getTemperature() {
-	// Send 1 shot start: 10110000 = 0xB0
-	unsigned char oneShotStart[2] = {0x80, 0xB0};
-	this->spiWriteRead(oneShotStart, 2);
+void TemperatureProbe::initialize() {
+	// Set-up the configuration register of the MAX31865, ready it for 1-shot conversion using 3-wire RTD, and
+	// clear the fault register
+	writeConfig(configByte() | CONFIG_FAULT_CLEAR);
 
-	// Wait for DRDY to go low
-	while(spiDRDY.getValue()) {
-		usleep(10000); // sleep for 10 ms
-	}
+	// Delay to allow the RC network to settle 10ms
+	pause(BIAS_SETTLE_USECS);
+}
 
-	// Read RTD Registers: send 01, read a byte, read a byte
-	unsigned char getTempData[3] = {0x01, 0x00, 0x00};
-	this->spiWriteRead(getTempData, 3);
+double TemperatureProbe::getTemperature() {
+	// Convert the average code once, then filter it
+	temperature = codeToTemperature((double)readCodeSum() / oversampling, currentUnit);
 
-	// See if the RTD Registers fault bit is set.
-	if (getTempData[2] & 0x01) {
-		// Fault bit is set, throw exception!
-		throw std::runtime_error("Fault bit set on temperature read.");
+	if (sampleFilter != nullptr) {
+		temperature = sampleFilter->filter(temperature);
 	}
 
-	// Get the ADC code from the received data
-	unsigned int adcCode = (getTempData[1] << 7) + (getTempData[2] >> 1);
+	return temperature;
+}
 
-	// Convert this to the RTD adc value
-	double adcValue =(adcCode*385)/pow(2, 15);
+template<TemperatureProbe::UNIT U>
+TemperatureProbe::Millidegrees<U> TemperatureProbe::getMillidegrees() {
+	return codeToMillidegrees<U>(readCodeSum(), oversampling);
+}
 
-	// Store needed values for accurate conversion
-	double Z1 = -3.9083e-3;
-	double Z2 = 17.58480889e-6;
-	double Z3 = -23.10e-9;
-	double Z4 = -1.155e-6;
+uint32_t TemperatureProbe::readCodeSum() {
+	// With the bias on demand, turn it on once for all the raw readings and give the RC network time to settle
+	bool biasOnDemand = (biasMode == BIAS_ON_DEMAND && conversionMode == ONE_SHOT);
+	if (biasOnDemand) {
+		writeConfig(configByte() | CONFIG_VBIAS);
+		pause(BIAS_SETTLE_USECS);
+	}
 
-	// Convert reading to temperature
-	temperature = (Z1 + sqrt(Z2+(Z3*adcValue)))/Z4;
+	// Sum the raw codes in integer space
+	uint32_t codeSum = 0;
+	try {
+		for (unsigned int i = 0; i < oversampling; i++) {
+			codeSum += readRawCode();
+		}
+	} catch (...) {
+		// Don't leave the bias on if a reading failed
+		if (biasOnDemand) {
+			writeConfig(configByte());
+		}
+		throw;
+	}
 
-	// Check and see if it needs to be converted to degrees F
-	if (currentUnit == FAHRENHEIT) {
-		temperature = (temperature*1.8) + 32.0;
+	if (biasOnDemand) {
+		writeConfig(configByte());
 	}
 
-	return temperature;
+	return codeSum;
 }
 
 void TemperatureProbe::setUnit(const UNIT newUnit) {
+	// The filter's history is in the old unit, so it has to start over
+	if (newUnit != currentUnit && sampleFilter != nullptr) {
+		sampleFilter->reset();
+	}
+
 	currentUnit = newUnit;
 }
 
@@ -88,13 +113,22 @@ void TemperatureProbe::setChipSelect(const unsigned int newChipSelect) {
 	if(currentChipSelect != newChipSelect) {
 		currentChipSelect = newChipSelect;
 
-		spiClose();
-
-		if(currentChipSelect == SPI_CE0) {
-			spiOpen(std::string("/dev/spidev0.0"));
+		if (bus != nullptr) {
+			bus->selectChip(currentChipSelect);
 		} else {
-			spiOpen(std::string("/dev/spidev0.1"));
+			spiClose();
+
+			if(currentChipSelect == SPI_CE0) {
+				spiOpen(std::string("/dev/spidev0.0"));
+			} else {
+				spiOpen(std::string("/dev/spidev0.1"));
+			}
 		}
+
+		// The other MAX31865 may not be set up the way we are, so give it our settings.  We don't know what it
+		// was doing, so treat it as if auto conversion was running.
+		writtenConfig = CONFIG_AUTO;
+		writeConfiguration();
 	}
 }
 
@@ -112,10 +146,270 @@ unsigned char TemperatureProbe::getFaultStatusRegister() const {
 
 void TemperatureProbe::clearFaultStatusRegister() const {
 	// Clear the Fault Register while maintaining our current settings.
-	unsigned char initConfig[2] = {0x80, 0x92};
+	unsigned char initConfig[2] = {0x80, (unsigned char)(configByte() | CONFIG_FAULT_CLEAR)};
 	this->spiWriteRead(initConfig, 2);
 }
 
+void TemperatureProbe::setWireMode(const WIRE_MODE newWireMode) {
+	wireMode = newWireMode;
+	writeConfiguration();
+}
+
+void TemperatureProbe::setNoiseFilter(const NOISE_FILTER newNoiseFilter) {
+	noiseFilter = newNoiseFilter;
+	writeConfiguration();
+}
+
+void TemperatureProbe::setBiasMode(const BIAS_MODE newBiasMode) {
+	biasMode = newBiasMode;
+	writeConfiguration();
+}
+
+void TemperatureProbe::setConversionMode(const CONVERSION_MODE newConversionMode) {
+	conversionMode = newConversionMode;
+	writeConfiguration();
+}
+
+TemperatureProbe::WIRE_MODE TemperatureProbe::getWireMode() const {
+	return wireMode;
+}
+
+TemperatureProbe::NOISE_FILTER TemperatureProbe::getNoiseFilter() const {
+	return noiseFilter;
+}
+
+TemperatureProbe::BIAS_MODE TemperatureProbe::getBiasMode() const {
+	return biasMode;
+}
+
+TemperatureProbe::CONVERSION_MODE TemperatureProbe::getConversionMode() const {
+	return conversionMode;
+}
+
+void TemperatureProbe::setOversampling(const unsigned int samples) {
+	if (samples == 0 || samples > MAX_OVERSAMPLING) {
+		throw std::runtime_error("Oversampling must be between 1 and MAX_OVERSAMPLING.");
+	}
+
+	oversampling = samples;
+}
+
+unsigned int TemperatureProbe::getOversampling() const {
+	return oversampling;
+}
+
+TemperatureProbe::Characterization TemperatureProbe::characterize(const unsigned int readings) {
+	Characterization result = {readings, oversampling, 0, 0, 0};
+	if (readings == 0) {
+		return result;
+	}
+
+	// Take the readings back to back, keeping a running mean & variance (Welford) so nothing needs storing
+	double mean = 0;
+	double sumSquares = 0;
+
+	uint64_t start = clockMicroseconds();
+	for (unsigned int i = 0; i < readings; i++) {
+		double reading = getTemperature();
+		double delta = reading - mean;
+		mean += delta / (i + 1);
+		sumSquares += delta * (reading - mean);
+	}
+	uint64_t end = clockMicroseconds();
+
+	double seconds = (end - start) / 1e6;
+	result.samplesPerSecond = readings / seconds;
+	result.mean = mean;
+	result.stddev = (readings > 1) ? sqrt(sumSquares / (readings - 1)) : 0;
+
+	return result;
+}
+
+void TemperatureProbe::setFilter(SampleFilter *newFilter) {
+	sampleFilter = newFilter;
+}
+
+SampleFilter *TemperatureProbe::getFilter() const {
+	return sampleFilter;
+}
+
+bool TemperatureProbe::dataReady() const {
+	if (bus != nullptr) {
+		return bus->dataReady();
+	}
+
+	return spiDRDY->getValue() == PinInput::LOW;
+}
+
+uint64_t TemperatureProbe::clockMicroseconds() const {
+	if (bus != nullptr) {
+		return bus->now();
+	}
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+void TemperatureProbe::pause(unsigned int microseconds) {
+	if (bus != nullptr) {
+		bus->wait(microseconds);
+	} else {
+		usleep(microseconds);
+	}
+}
+
+unsigned char TemperatureProbe::configByte() const {
+	unsigned char config = 0;
+
+	// Continuous conversion needs the bias on all the time
+	if (conversionMode == CONTINUOUS) {
+		config |= CONFIG_VBIAS | CONFIG_AUTO;
+	} else if (biasMode == BIAS_ALWAYS_ON) {
+		config |= CONFIG_VBIAS;
+	}
+
+	if (wireMode == THREE_WIRE) {
+		config |= CONFIG_3WIRE;
+	}
+
+	if (noiseFilter == FILTER_50HZ) {
+		config |= CONFIG_50HZ;
+	}
+
+	return config;
+}
+
+void TemperatureProbe::writeConfig(unsigned char config) {
+	// Write the configuration register: send 80, then the new value
+	unsigned char configWrite[2] = {0x80, config};
+	this->spiWriteRead(configWrite, 2);
+
+	// The self clearing bits never read back as set, so don't remember them
+	writtenConfig = config & ~(CONFIG_ONE_SHOT | CONFIG_FAULT_CLEAR);
+}
+
+void TemperatureProbe::writeConfiguration() {
+	// The MAX31865 doesn't allow the filter to change while auto conversion is running, so stop it first.
+	if (writtenConfig & CONFIG_AUTO) {
+		writeConfig(writtenConfig & ~CONFIG_AUTO);
+	}
+
+	writeConfig(configByte());
+}
+
+unsigned int TemperatureProbe::readRawCode() {
+	BREW_TRACE_ASYNC_BEGIN("conversion", currentChipSelect);
+
+	// In one-shot mode start a conversion: our configuration plus the bias and 1 shot bits
+	if (conversionMode == ONE_SHOT) {
+		unsigned char oneShotStart[2] = {0x80, (unsigned char)(configByte() | CONFIG_VBIAS | CONFIG_ONE_SHOT)};
+		this->spiWriteRead(oneShotStart, 2);
+	}
+
+	// Wait for DRDY to go low
+	{
+		BREW_LATENCY_SCOPE(DRDY_WAIT);
+		while(!dataReady()) {
+			pause(10000); // sleep for 10 ms
+		}
+	}
+	BREW_TRACE_INSTANT("drdy", currentChipSelect, 0);
+
+	// Read RTD Registers: send 01, read a byte, read a byte
+	unsigned char getTempData[3] = {0x01, 0x00, 0x00};
+	BREW_TRACE_BEGIN("rtd read", currentChipSelect);
+	this->spiWriteRead(getTempData, 3);
+	BREW_TRACE_END("rtd read", currentChipSelect);
+	BREW_TRACE_ASYNC_END("conversion", currentChipSelect);
+
+	// See if the RTD Registers fault bit is set.
+	if (getTempData[2] & 0x01) {
+		// Fault bit is set, throw exception!
+		throw std::runtime_error("Fault bit set on temperature read.");
+	}
+
+	// Get the ADC code from the received data
+	return (getTempData[1] << 7) + (getTempData[2] >> 1);
+}
+
+double TemperatureProbe::codeToTemperature(double adcCode, UNIT unit) {
+	// Convert this to the RTD adc value
+	double adcValue =(adcCode*385)/pow(2, 15);
+
+	// Store needed values for accurate conversion
+	double Z1 = -3.9083e-3;
+	double Z2 = 17.58480889e-6;
+	double Z3 = -23.10e-9;
+	double Z4 = -1.155e-6;
+
+	// Convert reading to temperature
+	double converted = (Z1 + sqrt(Z2+(Z3*adcValue)))/Z4;
+
+	// Check and see if it needs to be converted to degrees F
+	if (unit == FAHRENHEIT) {
+		converted = (converted*1.8) + 32.0;
+	}
+
+	return converted;
+}
+
+namespace {
+	/*
+	 * 	The millidegree conversion uses a table of the temperature at every 64th ADC code and interpolates between
+	 * 	entries.  The curve is smooth enough that the interpolation error stays under half a millidegree.
+	 */
+	const unsigned int SEGMENT_BITS = 6;
+	const unsigned int TABLE_SIZE = (1 << (15 - SEGMENT_BITS)) + 1;
+
+	// Bits of fraction kept below the ADC code when averaging oversampled codes
+	const unsigned int CODE_FRACTION_BITS = 7;
+
+	struct MillidegreeTable {
+		int32_t entry[TABLE_SIZE];
+
+		explicit MillidegreeTable(TemperatureProbe::UNIT unit) {
+			for (unsigned int i = 0; i < TABLE_SIZE; i++) {
+				entry[i] = (int32_t)llround(TemperatureProbe::codeToTemperature(i << SEGMENT_BITS, unit) * 1000.0);
+			}
+		}
+	};
+
+	// Built on first use rather than during static initialization, so a conversion from another file's static
+	// constructor still finds it filled in.  After that the conversion itself never touches the FPU.
+	template<TemperatureProbe::UNIT U>
+	const MillidegreeTable &millidegreeTable() {
+		static const MillidegreeTable table(U);
+		return table;
+	}
+}
+
+template<TemperatureProbe::UNIT U>
+TemperatureProbe::Millidegrees<U> TemperatureProbe::codeToMillidegrees(uint32_t codeSum, unsigned int count) {
+	const int32_t *table = millidegreeTable<U>().entry;
+
+	// Average the codes keeping CODE_FRACTION_BITS of fraction, then split that into a table index and the position
+	// between it and the next entry
+	uint32_t code = (count == 1) ? (codeSum << CODE_FRACTION_BITS) : (codeSum << CODE_FRACTION_BITS) / count;
+	const unsigned int positionBits = SEGMENT_BITS + CODE_FRACTION_BITS;
+	uint32_t index = code >> positionBits;
+	int32_t position = code & ((1 << positionBits) - 1);
+
+	// Entries only increase, so step * position is never negative and the shift rounds it correctly
+	int32_t step = table[index + 1] - table[index];
+	Millidegrees<U> result = {table[index] + ((step * position + (1 << (positionBits - 1))) >> positionBits)};
+
+	return result;
+}
+
+// The two units are all there is, so instantiate both here and keep the tables private to this file
+template TemperatureProbe::Millidegrees<TemperatureProbe::CELSIUS> TemperatureProbe::getMillidegrees();
+template TemperatureProbe::Millidegrees<TemperatureProbe::FAHRENHEIT> TemperatureProbe::getMillidegrees();
+template TemperatureProbe::Millidegrees<TemperatureProbe::CELSIUS>
+	TemperatureProbe::codeToMillidegrees(uint32_t codeSum, unsigned int count);
+template TemperatureProbe::Millidegrees<TemperatureProbe::FAHRENHEIT>
+	TemperatureProbe::codeToMillidegrees(uint32_t codeSum, unsigned int count);
+
 int TemperatureProbe::spiOpen(std::string devspi) {
 	int statusVal = -1;
 
@@ -157,7 +451,14 @@ int TemperatureProbe::spiOpen(std::string devspi) {
 	return statusVal;
 }
 
-int TemperatureProbe::spiWriteRead( unsigned char *data, int length) {
+int TemperatureProbe::spiWriteRead( unsigned char *data, int length) const {
+	// Hand the transfer to the bus if we have one
+	if (bus != nullptr) {
+		BREW_LATENCY_SCOPE(SPI_TRANSFER);
+		bus->transfer(data, length);
+		return length;
+	}
+
 	struct spi_ioc_transfer spi[length];
 	int i = 0;
 	int retVal = -1;
@@ -173,7 +474,10 @@ int TemperatureProbe::spiWriteRead( unsigned char *data, int length) {
 		spi[i].cs_change = 0;
 	}
 
-	retVal = ioctl (spifd, SPI_IOC_MESSAGE(length), &spi) ;
+	{
+		BREW_LATENCY_SCOPE(SPI_TRANSFER);
+		retVal = ioctl (spifd, SPI_IOC_MESSAGE(length), &spi) ;
+	}
 
 	if(retVal < 0){
 		throw std::runtime_error("Problem transmitting spi data..ioctl");
@@ -9,6 +9,20 @@
  * 				enum UNIT.  This enum defines all the units it is possible to store temperature in.  The currently used unit can be
  * 				set using setUnit() and retrieved using getUnit().
  *
+ * 				How the MAX31865 converts is set with setWireMode(), setNoiseFilter(), setBiasMode() and setConversionMode().
+ * 				The defaults (3-wire, 60Hz filter, bias always on, one-shot) match the original hard coded configuration.
+ * 				setOversampling() averages several raw ADC codes per reading, trading samples/sec for noise, and
+ * 				characterize() measures the samples/sec and noise actually achieved with the current settings.
+ * 				setFilter() attaches a SampleFilter which every reading is passed through before it is returned.
+ *
+ * 				getMillidegrees<UNIT>() is an integer alternative to getTemperature() for slow or FPU-less boards.  It
+ * 				returns Millidegrees<UNIT>, a signed count of thousandths of a degree, converted from the ADC code with a
+ * 				table and linear interpolation.  Over every 15 bit code it is within 1.5 millidegrees of the double path
+ * 				(see bench/FixedPointBench.cpp).
+ *
+ * 				Normally the probe talks to the MAX31865 through spidev and the DRDY pin.  It can instead be given an
+ * 				SpiBus, e.g. a simulated MAX31865, to run without the hardware.
+ *
  * 				TemperatureProbe throws std::runtime_error upon exceptions.
  *
  *  Created on: Nov 30, 2013
@@ -30,8 +44,13 @@
 #include <cmath>
 #include <exception>
 #include <stdexcept>
+#include <memory>
 #include "PinAssignments.h"
 #include "PinInput.h"
+#include "LatencyHistogram.h"
+#include "EventTracer.h"
+#include "SampleFilter.h"
+#include "SpiBus.h"
 
 class TemperatureProbe {
 public:
@@ -51,18 +70,106 @@ public:
 					RTDIN_LESS_THAN=0x08,
 					OVER_UNDER_VOLTAGE=0x04};
 
+	/*
+	 * 	WIRE_MODE - how the RTD is wired to the MAX31865.  2 & 4 wire share a configuration.
+	 */
+	enum WIRE_MODE {TWO_WIRE, THREE_WIRE, FOUR_WIRE};
+
+	/*
+	 * 	NOISE_FILTER - which mains frequency the MAX31865's notch filter rejects.  The 50Hz filter makes each
+	 * 			conversion slower (62.5ms vs 52ms one-shot, 20ms vs 16.7ms continuous).
+	 */
+	enum NOISE_FILTER {FILTER_60HZ, FILTER_50HZ};
+
+	/*
+	 * 	BIAS_MODE - BIAS_ALWAYS_ON leaves the RTD bias voltage on between readings.  BIAS_ON_DEMAND only turns it on
+	 * 			for each one-shot reading, which cuts self heating but adds the bias settle time to every reading.
+	 * 			Continuous conversion always keeps the bias on.
+	 */
+	enum BIAS_MODE {BIAS_ALWAYS_ON, BIAS_ON_DEMAND};
+
+	/*
+	 * 	CONVERSION_MODE - ONE_SHOT starts a conversion for every raw reading.  CONTINUOUS lets the MAX31865 convert
+	 * 			back to back (60 or 50 per second) and each raw reading waits for the next one to finish.
+	 */
+	enum CONVERSION_MODE {ONE_SHOT, CONTINUOUS};
+
+	/*
+	 * 	MAX_OVERSAMPLING - the most codes setOversampling() allows per reading.  Keeps the integer math of
+	 * 			codeToMillidegrees() within 32 bits.
+	 */
+	static const unsigned int MAX_OVERSAMPLING = 512;
+
+	/*
+	 * 	Millidegrees - a temperature in thousandths of a degree of unit U, e.g. 152500 is 152.5 degrees.  The unit is
+	 * 			part of the type so Celsius and Fahrenheit readings can't be mixed up.
+	 */
+	template<UNIT U>
+	struct Millidegrees {
+		int32_t value;
+
+		bool operator==(const Millidegrees &other) const { return value == other.value; }
+		bool operator!=(const Millidegrees &other) const { return value != other.value; }
+		bool operator<(const Millidegrees &other) const { return value < other.value; }
+		bool operator<=(const Millidegrees &other) const { return value <= other.value; }
+		bool operator>(const Millidegrees &other) const { return value > other.value; }
+		bool operator>=(const Millidegrees &other) const { return value >= other.value; }
+	};
+
+	/*
+	 * 	Characterization - what characterize() measured.  mean & stddev are in the current unit.
+	 */
+	struct Characterization {
+		unsigned int readings;
+		unsigned int oversampling;
+		double samplesPerSecond;
+		double mean;
+		double stddev;
+	};
+
 	TemperatureProbe(unsigned int newChipSelect = SPI_CE0, UNIT newUnit = FAHRENHEIT);
+
+	/*
+	 * 	Talks to the MAX31865 through newBus instead of spidev and the DRDY pin.  The probe does not own the bus,
+	 * 	which must outlive it.
+	 */
+	TemperatureProbe(SpiBus &newBus, unsigned int newChipSelect = SPI_CE0, UNIT newUnit = FAHRENHEIT);
 	virtual ~TemperatureProbe();
 
 	/*
-	 *	getTemperature() - returns the current temperature.
+	 *	getTemperature() - returns the current temperature, passed through the attached filter if there is one.
 	 *	@return - current temperature as a double.
 	 *	@throws - std::runtime_error when a fault bit in the MAX31865 is set.
 	 */
 	double getTemperature();
 
 	/*
-	 *	setUnit() - changes how the temperature is stored and returned.
+	 * 	getMillidegrees() - returns the current temperature in millidegrees of U using only integer math.  Ignores the
+	 * 			current unit and does not go through the attached filter, which works in doubles.
+	 * 	@return - current temperature in millidegrees of U.
+	 * 	@throws - std::runtime_error when a fault bit in the MAX31865 is set.
+	 */
+	template<UNIT U>
+	Millidegrees<U> getMillidegrees();
+
+	/*
+	 * 	codeToMillidegrees() - converts the sum of count 15 bit ADC codes to millidegrees of U with integer math.
+	 * 	@params - codeSum - the sum of the codes.
+	 * 			- count - how many codes were summed, at least 1.
+	 * 	@return - the temperature the average code represents.
+	 */
+	template<UNIT U>
+	static Millidegrees<U> codeToMillidegrees(uint32_t codeSum, unsigned int count);
+
+	/*
+	 * 	codeToTemperature() - the double conversion getTemperature() uses, exposed for comparison.
+	 * 	@params - adcCode - an (averaged) 15 bit ADC code.
+	 * 			- unit - the unit to return.
+	 */
+	static double codeToTemperature(double adcCode, UNIT unit);
+
+	/*
+	 *	setUnit() - changes how the temperature is stored and returned.  Resets the attached filter if the unit changes.
 	 *	@post - the temperature will be stored and returned as degrees newUnit.
 	 *	@params - Unit newUnit - the unit the temperature should be stored and returned as.
 	 */
@@ -102,7 +209,78 @@ public:
 	 */
 	void clearFaultStatusRegister() const;
 
+	/*
+	 * 	setWireMode(), setNoiseFilter(), setBiasMode(), setConversionMode() - change how the MAX31865 converts.  Each
+	 * 			writes the new configuration to the MAX31865 straight away.
+	 * 	@post - following readings use the new setting.
+	 * 	@throws - std::runtime_error
+	 */
+	void setWireMode(const WIRE_MODE newWireMode);
+	void setNoiseFilter(const NOISE_FILTER newNoiseFilter);
+	void setBiasMode(const BIAS_MODE newBiasMode);
+	void setConversionMode(const CONVERSION_MODE newConversionMode);
+
+	/*
+	 * 	getWireMode(), getNoiseFilter(), getBiasMode(), getConversionMode() - return the current settings.
+	 */
+	WIRE_MODE getWireMode() const;
+	NOISE_FILTER getNoiseFilter() const;
+	BIAS_MODE getBiasMode() const;
+	CONVERSION_MODE getConversionMode() const;
+
+	/*
+	 * 	setOversampling() - sets how many raw ADC codes are summed and averaged for each reading.  The average is
+	 * 			converted to a temperature once, so oversampling costs conversion time but no extra math.
+	 * 	@params - samples - codes per reading, 1 turns oversampling off.
+	 * 	@throws - std::runtime_error if samples is 0 or more than MAX_OVERSAMPLING.
+	 */
+	void setOversampling(const unsigned int samples);
+
+	/*
+	 * 	getOversampling() - returns how many raw ADC codes are averaged for each reading.
+	 */
+	unsigned int getOversampling() const;
+
+	/*
+	 * 	characterize() - takes readings back to back with the current settings and measures how fast they come and
+	 * 			how noisy they are.  Meant to be run with the probe in a stable bath.  Readings go through the
+	 * 			attached filter, so detach it to characterize the MAX31865 settings alone.  With an SpiBus the time is
+	 * 			the bus's clock, so a simulated chip reports its simulated conversion rate.
+	 * 	@params - readings - how many readings to take.
+	 * 	@return - the effective samples/sec and the mean & standard deviation of the readings.
+	 * 	@throws - std::runtime_error when a fault bit in the MAX31865 is set.
+	 */
+	Characterization characterize(const unsigned int readings);
+
+	/*
+	 * 	setFilter() - attaches a filter to the readings.  The probe does not own the filter, which must outlive it or be
+	 * 			detached first.  The filter is not reset, call its reset() if it has seen another stream.
+	 * 	@params - newFilter - the filter to use, or nullptr to return raw readings.
+	 */
+	void setFilter(SampleFilter *newFilter);
+
+	/*
+	 * 	getFilter() - returns the attached filter, or nullptr if there is none.
+	 */
+	SampleFilter *getFilter() const;
+
 private:
+	/*
+	 * 	CONFIG_BITS - the bits of the MAX31865 configuration register.
+	 */
+	enum CONFIG_BITS {CONFIG_VBIAS=0x80,
+					CONFIG_AUTO=0x40,
+					CONFIG_ONE_SHOT=0x20,
+					CONFIG_3WIRE=0x10,
+					CONFIG_FAULT_CLEAR=0x02,
+					CONFIG_50HZ=0x01};
+
+	/*
+	 * 	BIAS_SETTLE_USECS - how long the RC network on the RTD inputs needs after the bias is turned on.
+	 */
+	static const unsigned int BIAS_SETTLE_USECS = 10000;
+
+
 	/*
 	 *	temperature - stores the current temperature.  The units temperature can be stored as are defined in the enum UNIT.  The
 	 *			current unit temperature is being stored and returned as is stored in currentUnit.
@@ -119,6 +297,29 @@ private:
 	 */
 	unsigned int currentChipSelect;
 
+	/*
+	 * 	wireMode, noiseFilter, biasMode, conversionMode - the current MAX31865 settings.
+	 */
+	WIRE_MODE wireMode;
+	NOISE_FILTER noiseFilter;
+	BIAS_MODE biasMode;
+	CONVERSION_MODE conversionMode;
+
+	/*
+	 * 	oversampling - how many raw ADC codes are averaged for each reading.
+	 */
+	unsigned int oversampling;
+
+	/*
+	 * 	sampleFilter - filter every reading is passed through, nullptr for none.  Not owned.
+	 */
+	SampleFilter *sampleFilter;
+
+	/*
+	 * 	writtenConfig - the configuration byte last written to the MAX31865.
+	 */
+	unsigned char writtenConfig;
+
 	/*
 	 *****	SPI INTERFACE DEFINITIONS	*****
 	 *	The variables are set to default values
@@ -133,13 +334,28 @@ private:
 	int spifd;	// SPI file descriptor.
 
 	/*
-	 *	spiDRDY - input pin which goes low when the temperature conversion is ready to be read.
+	 *	spiDRDY - input pin which goes low when the temperature conversion is ready to be read.  Null when using bus.
 	 */
-	PinInput spiDRDY;
+	std::unique_ptr<PinInput> spiDRDY;
+
+	/*
+	 * 	bus - the SpiBus used instead of spidev and spiDRDY, or null.  Not owned.
+	 */
+	SpiBus *bus;
 
 	int spiOpen(std::string devspi);	// Opens an SPI device for comms. @throws - std::runtime_error
-	int spiWriteRead( unsigned char *data, int length);	// writes data of length to the SPI device.  Recieved data is written back to data. @throws - std::runtime_error
+	int spiWriteRead( unsigned char *data, int length) const;	// writes data of length to the SPI device.  Recieved data is written back to data. @throws - std::runtime_error
 	int spiClose();	// Closes the SPI device. @throws - std::runtime_error
+
+	void initialize();	// Configures the MAX31865 and lets the RC network settle. @throws - std::runtime_error
+	bool dataReady() const;	// True once DRDY is low. @throws - std::runtime_error
+	void pause(unsigned int microseconds);	// Sleeps, or lets the bus's time pass.
+	uint64_t clockMicroseconds() const;	// The bus's clock, or CLOCK_MONOTONIC without a bus.
+	unsigned char configByte() const;	// Builds the configuration register value for the current settings.
+	void writeConfig(unsigned char config);	// Writes config to the configuration register. @throws - std::runtime_error
+	void writeConfiguration();	// Writes the current settings, stopping auto conversion first. @throws - std::runtime_error
+	unsigned int readRawCode();	// Waits for a conversion and returns its 15 bit ADC code. @throws - std::runtime_error
+	uint32_t readCodeSum();	// Sums oversampling raw codes, handling bias on demand. @throws - std::runtime_error
 };
 
 #endif /* TEMPERATUREPROBE_H_ */
@@ -0,0 +1,108 @@
+/*
+ * ThreadRegistry.h - hands every thread its own instance of T and keeps a lock-free list of all of them so another
+ * 			thread can walk and merge them.  Instances are never freed; when a thread exits its slot is marked free and
+ * 			the next new thread claims it (along with whatever data it holds).  This keeps the number of slots bounded
+ * 			by the peak number of live threads, and means a reader walking the list can never touch freed memory.
+ *
+ * 			The owning thread is the only writer of its slot, so T should be built from std::atomic members which the
+ * 			owner updates with relaxed load/store pairs and readers read with relaxed loads.
+ *
+ * 			Example usage:	- Counters &mine = ThreadRegistry<Counters>::local();
+ * 							- ThreadRegistry<Counters>::forEach([](Counters &c, unsigned int slot) {...});
+ *
+ * 	Requires C++11 (-std=c++0x command line option)
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#ifndef THREADREGISTRY_H_
+#define THREADREGISTRY_H_
+
+#include <atomic>
+
+template<typename T>
+class ThreadRegistry {
+public:
+	/*
+	 * 	local() - returns the calling thread's instance, claiming a slot the first time it is called on a thread.
+	 * 	@return - the calling thread's instance of T.
+	 */
+	static T &local() {
+		static thread_local Holder holder;
+		return holder.node->data;
+	}
+
+	/*
+	 * 	forEach() - calls visit(T &data, unsigned int slot) for every slot ever claimed, live or free.  Safe to call
+	 * 			concurrently with local() from any thread.
+	 * 	@params - visit - callable invoked once per slot.
+	 */
+	template<typename VISITOR>
+	static void forEach(VISITOR visit) {
+		for (Node *node = head.load(std::memory_order_acquire); node != nullptr; node = node->next) {
+			visit(node->data, node->slot);
+		}
+	}
+
+private:
+	/*
+	 * 	Node - one slot in the list.  next and slot never change once the node is published.
+	 */
+	struct Node {
+		T data;
+		std::atomic<bool> inUse;
+		Node *next;
+		unsigned int slot;
+	};
+
+	/*
+	 * 	Holder - thread_local owner of a claimed node.  Its destructor hands the node back when the thread exits.
+	 */
+	struct Holder {
+		Node *node;
+
+		Holder() : node(claim()) {}
+		~Holder() { node->inUse.store(false, std::memory_order_release); }
+	};
+
+	/*
+	 * 	claim() - reuses a free node if there is one, otherwise pushes a new one onto the list.
+	 */
+	static Node *claim() {
+		for (Node *node = head.load(std::memory_order_acquire); node != nullptr; node = node->next) {
+			bool expected = false;
+			if (node->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+				return node;
+			}
+		}
+
+		Node *node = new Node();
+		node->inUse.store(true, std::memory_order_relaxed);
+		node->slot = slotCount.fetch_add(1, std::memory_order_relaxed);
+		node->next = head.load(std::memory_order_relaxed);
+		while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+			// node->next was reloaded with the current head, try again
+		}
+
+		return node;
+	}
+
+	/*
+	 * 	head - the most recently created node.  Nodes are only ever added, never removed.
+	 */
+	static std::atomic<Node *> head;
+
+	/*
+	 * 	slotCount - number of nodes created so far, used to number the slots.
+	 */
+	static std::atomic<unsigned int> slotCount;
+};
+
+template<typename T>
+std::atomic<typename ThreadRegistry<T>::Node *> ThreadRegistry<T>::head(nullptr);
+
+template<typename T>
+std::atomic<unsigned int> ThreadRegistry<T>::slotCount(0);
+
+#endif /* THREADREGISTRY_H_ */
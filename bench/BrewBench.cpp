@@ -0,0 +1,342 @@
+/*
+ * BrewBench.cpp - end to end benchmark of the brew I/O stack: GPIO MMIO, sysfs I/O, SPI transfer, DRDY wait and
+ * 			RTD conversion.  Runs without hardware: gpioPin maps a file standing in for /dev/gpiomem, PinOutput and
+ * 			PinInput use a fake sysfs in a temporary directory, and TemperatureProbe talks to a SimulatedMax31865.
+ * 			The numbers are the cost of our own code paths (plus the kernel's file I/O for sysfs), not of the Pi's
+ * 			peripherals.
+ *
+ * 			Each benchmark runs 5 times.  Results are printed as JSON on stdout with a stable layout, so runs can be
+ * 			diffed or fed to a regression check between releases:
+ * 				{"suite": "brew-io", "schema": 1, "config": {...},
+ * 				 "results": [{"name", "iterations", "ns_per_op", "ns_per_op_min", "ops_per_sec"}, ...]}
+ * 			ns_per_op is the median of the runs and ops_per_sec is based on it.  Built with BREW_LATENCY_HISTOGRAMS,
+ * 			a "latency" array follows the results with LatencyHistogram::snapshot() of every operation over the
+ * 			whole run: [{"name", "count", "mean_ns", "p50_ns", "p99_ns", "p999_ns", "max_ns"}, ...].
+ *
+ * 			Build & run:	- cmake -S .. -B build && cmake --build build --target BrewBench
+ * 							- build/BrewBench [scale]	(scale multiplies the iteration counts, default 1)
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#include "gpioPin.h"
+#include "StaticGpioPin.h"
+#include "PinOutput.h"
+#include "PinInput.h"
+#include "TemperatureProbe.h"
+#include "SimulatedMax31865.h"
+#include "SampleFilter.h"
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace {
+	const unsigned int REPETITIONS = 5;
+
+	struct Result {
+		std::string name;
+		unsigned long iterations;
+		double nsPerOp;
+		double nsPerOpMin;
+	};
+
+	std::vector<Result> results;
+
+	uint64_t now() {
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	}
+
+	// Times iterations calls of op, REPETITIONS times, and records the median and fastest ns per call
+	template<typename OP>
+	void measure(const char *name, unsigned long iterations, OP op) {
+		std::vector<double> runs;
+
+		for (unsigned int r = 0; r < REPETITIONS; r++) {
+			uint64_t start = now();
+			for (unsigned long i = 0; i < iterations; i++) {
+				op(i);
+			}
+			runs.push_back((double)(now() - start) / iterations);
+		}
+
+		std::sort(runs.begin(), runs.end());
+		results.push_back(Result{name, iterations, runs[REPETITIONS / 2], runs[0]});
+	}
+
+	void writeFile(const std::string &path, const std::string &contents) {
+		std::ofstream file(path.c_str());
+		file << contents;
+		if (!file) {
+			throw std::ofstream::failure("Unable to create " + path);
+		}
+	}
+
+	// Builds a fake root holding dev/gpiomem and the sysfs files for the pins used, returns its path
+	std::string makeFakeRoot() {
+		char pattern[] = "/tmp/brewbench.XXXXXX";
+		if (mkdtemp(pattern) == NULL) {
+			throw std::runtime_error("Unable to create the fake root.");
+		}
+		std::string root = pattern;
+
+		const unsigned int pins[] = {PUMP_PIN, DRDY_PIN};
+		std::vector<std::string> dirs = {"/dev", "/sys", "/sys/class", "/sys/class/gpio"};
+		for (unsigned int pin : pins) {
+			dirs.push_back("/sys/class/gpio/gpio" + std::to_string(pin));
+		}
+		for (const std::string &dir : dirs) {
+			if (mkdir((root + dir).c_str(), 0700) != 0) {
+				throw std::runtime_error("Unable to create " + root + dir);
+			}
+		}
+
+		writeFile(root + "/dev/gpiomem", std::string(BLOCK_SIZE, '\0'));
+		writeFile(root + "/sys/class/gpio/export", "");
+		writeFile(root + "/sys/class/gpio/unexport", "");
+		for (unsigned int pin : pins) {
+			std::string dir = root + "/sys/class/gpio/gpio" + std::to_string(pin);
+			writeFile(dir + "/direction", "in");
+			writeFile(dir + "/value", "1");
+		}
+
+		return root;
+	}
+
+	void removeFakeRoot(const std::string &root) {
+		const unsigned int pins[] = {PUMP_PIN, DRDY_PIN};
+		for (unsigned int pin : pins) {
+			std::string dir = root + "/sys/class/gpio/gpio" + std::to_string(pin);
+			unlink((dir + "/direction").c_str());
+			unlink((dir + "/value").c_str());
+			rmdir(dir.c_str());
+		}
+		unlink((root + "/sys/class/gpio/export").c_str());
+		unlink((root + "/sys/class/gpio/unexport").c_str());
+		unlink((root + "/dev/gpiomem").c_str());
+
+		const char *dirs[] = {"/sys/class/gpio", "/sys/class", "/sys", "/dev", ""};
+		for (const char *dir : dirs) {
+			rmdir((root + dir).c_str());
+		}
+	}
+
+	void printJson() {
+#ifdef BREW_LATENCY_HISTOGRAMS
+		const char *histograms = "true";
+#else
+		const char *histograms = "false";
+#endif
+#ifdef BREW_EVENT_TRACING
+		const char *tracing = "true";
+#else
+		const char *tracing = "false";
+#endif
+
+		printf("{\n");
+		printf("  \"suite\": \"brew-io\",\n");
+		printf("  \"schema\": 1,\n");
+		printf("  \"config\": {\"compiler\": \"%s\", \"latency_histograms\": %s, \"event_tracing\": %s, "
+				"\"repetitions\": %u},\n", __VERSION__, histograms, tracing, REPETITIONS);
+		printf("  \"results\": [\n");
+		for (size_t i = 0; i < results.size(); i++) {
+			const Result &r = results[i];
+			printf("    {\"name\": \"%s\", \"iterations\": %lu, \"ns_per_op\": %.2f, \"ns_per_op_min\": %.2f, "
+					"\"ops_per_sec\": %.0f}%s\n", r.name.c_str(), r.iterations, r.nsPerOp, r.nsPerOpMin,
+					1e9 / r.nsPerOp, (i + 1 < results.size()) ? "," : "");
+		}
+#ifdef BREW_LATENCY_HISTOGRAMS
+		printf("  ],\n");
+		printf("  \"latency\": [\n");
+		for (unsigned int op = 0; op < LatencyHistogram::OPERATION_COUNT; op++) {
+			LatencyHistogram::OPERATION operation = (LatencyHistogram::OPERATION)op;
+			LatencyHistogram::Snapshot s = LatencyHistogram::snapshot(operation);
+			printf("    {\"name\": \"%s\", \"count\": %llu, \"mean_ns\": %llu, \"p50_ns\": %llu, \"p99_ns\": %llu, "
+					"\"p999_ns\": %llu, \"max_ns\": %llu}%s\n", LatencyHistogram::operationName(operation),
+					(unsigned long long)s.count, (unsigned long long)s.mean, (unsigned long long)s.p50,
+					(unsigned long long)s.p99, (unsigned long long)s.p999, (unsigned long long)s.max,
+					(op + 1 < LatencyHistogram::OPERATION_COUNT) ? "," : "");
+		}
+#endif
+		printf("  ]\n");
+		printf("}\n");
+	}
+}
+
+int main(int argc, char *argv[]) {
+	unsigned long scale = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1;
+	if (scale == 0) {
+		scale = 1;
+	}
+
+	std::string root = makeFakeRoot();
+	gpioPin::setSystemRoot(root);
+	PinOutput::setSystemRoot(root);
+	PinInput::setSystemRoot(root);
+
+	int status = 0;
+	try {
+		// GPIO MMIO
+		{
+			gpioPin pump(PUMP_PIN, gpioPin::OUT);
+			measure("gpio_mmio_write", 1000000 * scale, [&](unsigned long i) {
+				if (i & 1) {
+					pump.Off();
+				} else {
+					pump.On();
+				}
+			});
+
+			StaticGpioPin<PUMP_PIN> staticPump;
+			measure("gpio_mmio_write_static", 1000000 * scale, [&](unsigned long i) {
+				if (i & 1) {
+					staticPump.Off();
+				} else {
+					staticPump.On();
+				}
+			});
+
+			volatile int levelSink = 0;
+			measure("gpio_mmio_read", 1000000 * scale, [&](unsigned long) {
+				levelSink = pump.Value();
+			});
+			(void)levelSink;
+
+			measure("gpio_bank_write", 1000000 * scale, [&](unsigned long i) {
+				if (i & 1) {
+					gpioPin::clearBank(1u << PUMP_PIN);
+				} else {
+					gpioPin::setBank(1u << PUMP_PIN);
+				}
+			});
+		}
+
+		// sysfs I/O
+		{
+			PinOutput pump(PUMP_PIN);
+			measure("sysfs_write", 10000 * scale, [&](unsigned long i) {
+				if (i & 1) {
+					pump.Off();
+				} else {
+					pump.On();
+				}
+			});
+
+			// One DRDY poll of the real probe
+			PinInput drdy(DRDY_PIN);
+			volatile int valueSink = 0;
+			measure("sysfs_read", 10000 * scale, [&](unsigned long) {
+				valueSink = drdy.getValue();
+			});
+			(void)valueSink;
+		}
+
+		// SPI transfer, DRDY wait and conversion through the simulated MAX31865
+		{
+			SimulatedMax31865 chips;
+			chips.setTemperature(SPI_CE0, 66.0);
+			chips.setNoise(2.0);
+			TemperatureProbe probe(chips, SPI_CE0, TemperatureProbe::CELSIUS);
+
+			volatile unsigned char faultSink = 0;
+			measure("spi_transfer", 1000000 * scale, [&](unsigned long) {
+				faultSink = probe.getFaultStatusRegister();
+			});
+			(void)faultSink;
+
+			// A reading with the chip converting continuously, so readRawCode() starts no conversion and the
+			// time is its DRDY wait (polling, 10ms apart) plus the RTD read and conversion that follow.  The
+			// drdy_wait latency histogram times the wait loop alone.
+			SimulatedMax31865 continuousChip;
+			continuousChip.setTemperature(SPI_CE0, 66.0);
+			TemperatureProbe continuousProbe(continuousChip, SPI_CE0, TemperatureProbe::CELSIUS);
+			continuousProbe.setConversionMode(TemperatureProbe::CONTINUOUS);
+
+			volatile double temperatureSink = 0;
+			measure("drdy_wait", 100000 * scale, [&](unsigned long) {
+				temperatureSink = continuousProbe.getTemperature();
+			});
+
+			measure("probe_reading", 100000 * scale, [&](unsigned long) {
+				temperatureSink = probe.getTemperature();
+			});
+
+			volatile int32_t milliSink = 0;
+			measure("probe_reading_millidegrees", 100000 * scale, [&](unsigned long) {
+				milliSink = probe.getMillidegrees<TemperatureProbe::CELSIUS>().value;
+			});
+
+			probe.setOversampling(8);
+			measure("probe_reading_oversampled_8", 20000 * scale, [&](unsigned long) {
+				temperatureSink = probe.getTemperature();
+			});
+			(void)temperatureSink;
+			(void)milliSink;
+		}
+
+		// RTD conversion, codes spread over the brewing range
+		{
+			std::vector<uint32_t> codes(4096);
+			unsigned int seed = 12345;
+			for (size_t i = 0; i < codes.size(); i++) {
+				seed = seed * 1103515245 + 12345;
+				codes[i] = 8500 + (seed >> 16) % 3600;
+			}
+
+			volatile double doubleSink = 0;
+			measure("rtd_conversion_double", 1000000 * scale, [&](unsigned long i) {
+				doubleSink = TemperatureProbe::codeToTemperature(codes[i & 4095], TemperatureProbe::FAHRENHEIT);
+			});
+			(void)doubleSink;
+
+			volatile int32_t intSink = 0;
+			measure("rtd_conversion_fixed", 1000000 * scale, [&](unsigned long i) {
+				intSink = TemperatureProbe::codeToMillidegrees<TemperatureProbe::FAHRENHEIT>(codes[i & 4095], 1).value;
+			});
+			(void)intSink;
+		}
+
+		// Sample filters
+		{
+			SlidingMedian<9> median;
+			volatile double filterSink = 0;
+			measure("filter_median_9", 1000000 * scale, [&](unsigned long i) {
+				filterSink = median.filter(150.0 + (double)(i % 17) * 0.01);
+			});
+
+			SlidingMedian<5> chainMedian;
+			RateOfChangeRejector rejector(2.0, 3);
+			ExponentialMovingAverage ema(0.2);
+			FilterChain chain;
+			chain.append(chainMedian);
+			chain.append(rejector);
+			chain.append(ema);
+			measure("filter_chain", 1000000 * scale, [&](unsigned long i) {
+				filterSink = chain.filter(150.0 + (double)(i % 17) * 0.01);
+			});
+			(void)filterSink;
+		}
+	} catch (std::exception &e) {
+		fprintf(stderr, "BrewBench: %s\n", e.what());
+		status = 1;
+	}
+
+	gpioPin::unmapRegisters();
+	removeFakeRoot(root);
+
+	if (status == 0) {
+		printJson();
+	}
+
+	return status;
+}
@@ -0,0 +1,125 @@
+/*
+ * FilterBench.cpp - throughput of the SampleFilter stages on a synthetic RTD signal (slow ramp, noise and the odd
+ * 			pump/heater spike).  The sliding median is checked against a brute force median as it runs, for window
+ * 			sizes up to 1024; a window size that gets it wrong isn't timed and the exit status is 1.
+ *
+ * 			Build & run:	- cmake -S .. -B build && cmake --build build --target FilterBench
+ * 							- build/FilterBench [samples]
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#include "SampleFilter.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <time.h>
+#include <vector>
+
+static uint64_t now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Builds the test signal: 150F ramping up, +-0.1F noise and a 20F spike every 97 samples
+static std::vector<double> makeSignal(unsigned int samples) {
+	std::vector<double> signal(samples);
+	unsigned int seed = 12345;
+
+	for (unsigned int i = 0; i < samples; i++) {
+		seed = seed * 1103515245 + 12345;
+		double noise = ((seed >> 16) & 0x7FFF) / 32767.0 * 0.2 - 0.1;
+		signal[i] = 150.0 + i * 0.0001 + noise + ((i % 97 == 0) ? 20.0 : 0.0);
+	}
+
+	return signal;
+}
+
+// Runs the whole signal through filter and prints ns/sample
+static void run(const char *name, SampleFilter &filter, const std::vector<double> &signal) {
+	volatile double sink = 0;
+	filter.reset();
+
+	uint64_t start = now();
+	for (size_t i = 0; i < signal.size(); i++) {
+		sink = filter.filter(signal[i]);
+	}
+	uint64_t elapsed = now() - start;
+
+	printf("%-24s %8.1f ns/sample %10.2f Msamples/s\n", name, (double)elapsed / signal.size(),
+			signal.size() * 1000.0 / elapsed);
+	(void)sink;
+}
+
+// Checks SlidingMedian<WINDOW> against sorting a copy of the window
+template<unsigned int WINDOW>
+static bool checkMedian(const std::vector<double> &signal) {
+	SlidingMedian<WINDOW> median;
+	std::vector<double> window;
+
+	for (size_t i = 0; i < signal.size() && i < 20000; i++) {
+		double got = median.filter(signal[i]);
+
+		window.push_back(signal[i]);
+		if (window.size() > WINDOW) {
+			window.erase(window.begin());
+		}
+		std::vector<double> sorted(window);
+		std::sort(sorted.begin(), sorted.end());
+		size_t n = sorted.size();
+		double expected = (n % 2) ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+
+		if (got != expected) {
+			printf("SlidingMedian<%u> wrong at sample %zu: %f != %f\n", WINDOW, i, got, expected);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Times SlidingMedian<WINDOW> if it passes checkMedian(), returns false if it doesn't
+template<unsigned int WINDOW>
+static bool runMedian(const std::vector<double> &signal) {
+	static SlidingMedian<WINDOW> median;
+	char name[32];
+	snprintf(name, sizeof(name), "SlidingMedian<%u>", WINDOW);
+
+	if (!checkMedian<WINDOW>(signal)) {
+		return false;
+	}
+
+	run(name, median, signal);
+	return true;
+}
+
+int main(int argc, char *argv[]) {
+	unsigned int samples = (argc > 1) ? atoi(argv[1]) : 2000000;
+	std::vector<double> signal = makeSignal(samples);
+
+	ExponentialMovingAverage ema(0.1);
+	RateOfChangeRejector spikes(2.0, 3);
+	SlidingMedian<9> median;
+	FilterChain chain;
+	chain.append(spikes);
+	chain.append(median);
+	chain.append(ema);
+
+	run("ExponentialMovingAverage", ema, signal);
+	run("RateOfChangeRejector", spikes, signal);
+	run("rejector+median9+ema", chain, signal);
+
+	// Keep going after a wrong median so every window size is reported, but fail the run
+	bool correct = true;
+	correct &= runMedian<3>(signal);
+	correct &= runMedian<9>(signal);
+	correct &= runMedian<32>(signal);
+	correct &= runMedian<128>(signal);
+	correct &= runMedian<512>(signal);
+	correct &= runMedian<1024>(signal);
+
+	return correct ? 0 : 1;
+}
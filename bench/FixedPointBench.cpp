@@ -0,0 +1,77 @@
+/*
+ * FixedPointBench.cpp - compares TemperatureProbe's integer millidegree conversion with the double one: the largest
+ * 			difference over every 15 bit ADC code (plain and 4x oversampled) and conversions per second of each.
+ * 			No hardware is needed, only the static conversion functions are used.
+ *
+ * 			Build & run:	- cmake -S .. -B build && cmake --build build --target FixedPointBench
+ * 							- build/FixedPointBench
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#include "TemperatureProbe.h"
+#include <cstdio>
+#include <cstdint>
+#include <time.h>
+#include <vector>
+
+static uint64_t now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Largest |integer - double * 1000| over all code sums for count codes
+template<TemperatureProbe::UNIT U>
+static double maxError(unsigned int count) {
+	double worst = 0;
+
+	for (uint32_t codeSum = 0; codeSum <= 32767 * count; codeSum++) {
+		int32_t milli = TemperatureProbe::codeToMillidegrees<U>(codeSum, count).value;
+		double exact = TemperatureProbe::codeToTemperature((double)codeSum / count, U) * 1000.0;
+		double error = (milli > exact) ? milli - exact : exact - milli;
+
+		if (error > worst) {
+			worst = error;
+		}
+	}
+
+	return worst;
+}
+
+int main() {
+	printf("max |error| celsius:       %.3f millidegrees\n", maxError<TemperatureProbe::CELSIUS>(1));
+	printf("max |error| fahrenheit:    %.3f millidegrees\n", maxError<TemperatureProbe::FAHRENHEIT>(1));
+	printf("max |error| celsius x4:    %.3f millidegrees\n", maxError<TemperatureProbe::CELSIUS>(4));
+	printf("max |error| fahrenheit x4: %.3f millidegrees\n", maxError<TemperatureProbe::FAHRENHEIT>(4));
+
+	// Codes spread over the brewing range (roughly 0-110C) in a scrambled order
+	std::vector<uint32_t> codes(1 << 20);
+	unsigned int seed = 12345;
+	for (size_t i = 0; i < codes.size(); i++) {
+		seed = seed * 1103515245 + 12345;
+		codes[i] = 8500 + (seed >> 16) % 3600;
+	}
+
+	volatile double doubleSink = 0;
+	uint64_t start = now();
+	for (size_t i = 0; i < codes.size(); i++) {
+		doubleSink = TemperatureProbe::codeToTemperature(codes[i], TemperatureProbe::FAHRENHEIT);
+	}
+	uint64_t doubleElapsed = now() - start;
+
+	volatile int32_t intSink = 0;
+	start = now();
+	for (size_t i = 0; i < codes.size(); i++) {
+		intSink = TemperatureProbe::codeToMillidegrees<TemperatureProbe::FAHRENHEIT>(codes[i], 1).value;
+	}
+	uint64_t intElapsed = now() - start;
+
+	printf("double conversion:      %6.1f ns/code\n", (double)doubleElapsed / codes.size());
+	printf("millidegree conversion: %6.1f ns/code\n", (double)intElapsed / codes.size());
+	(void)doubleSink;
+	(void)intSink;
+
+	return 0;
+}
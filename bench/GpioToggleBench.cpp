@@ -0,0 +1,58 @@
+/*
+ * GpioToggleBench.cpp - toggle rate of the run time gpioPin against StaticGpioPin on PUMP_PIN.  Needs a Raspberry Pi
+ * 			and access to the GPIO registers.  Unplug the pump first!
+ *
+ * 			The toggle functions are kept out of line so their code can be compared:
+ * 							- objdump -d --no-show-raw-insn build/GpioToggleBench | c++filt | grep -A12 'toggle.*Pin'
+ * 			StaticGpioPin's On()/Off() inline to one immediate store each, with the register base load hoisted out
+ * 			of the loop.  gpioPin's are out of line calls which also check the direction and load the pin's mask.
+ *
+ * 			Build & run:	- cmake -S .. -B build && cmake --build build --target GpioToggleBench
+ * 							- build/GpioToggleBench [toggles]
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#include "StaticGpioPin.h"
+#include <cstdio>
+#include <cstdlib>
+#include <time.h>
+
+static uint64_t now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+__attribute__((noinline)) void toggleRuntimePin(gpioPin &pin, unsigned int toggles) {
+	for (unsigned int i = 0; i < toggles; i++) {
+		pin.On();
+		pin.Off();
+	}
+}
+
+__attribute__((noinline)) void toggleStaticPin(const StaticGpioPin<PUMP_PIN> &pin, unsigned int toggles) {
+	for (unsigned int i = 0; i < toggles; i++) {
+		pin.On();
+		pin.Off();
+	}
+}
+
+int main(int argc, char *argv[]) {
+	unsigned int toggles = (argc > 1) ? atoi(argv[1]) : 10000000;
+
+	gpioPin runtimePin(PUMP_PIN, gpioPin::OUT);
+	uint64_t start = now();
+	toggleRuntimePin(runtimePin, toggles);
+	uint64_t elapsed = now() - start;
+	printf("gpioPin:       %7.2f M toggles/s  %6.1f ns/edge\n", toggles * 1000.0 / elapsed, elapsed / (2.0 * toggles));
+
+	StaticGpioPin<PUMP_PIN> staticPin;
+	start = now();
+	toggleStaticPin(staticPin, toggles);
+	elapsed = now() - start;
+	printf("StaticGpioPin: %7.2f M toggles/s  %6.1f ns/edge\n", toggles * 1000.0 / elapsed, elapsed / (2.0 * toggles));
+
+	return 0;
+}
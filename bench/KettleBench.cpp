@@ -0,0 +1,257 @@
+/*
+ * KettleBench.cpp - closed loop run of a mash schedule against SimulatedKettle, faster than real time.  The
+ * 			controller is the one the rig would run: it reads the probe through TemperatureProbe and switches
+ * 			HE_PIN and PUMP_PIN with gpioPin, whose registers are a file the kettle model plays the GPIO block on.
+ * 			Simple on/off control with a little hysteresis, one loop a second.
+ *
+ * 			The schedule (strike heat from 20C, 60 minutes at 66C, 10 minutes at 76C) is run 5 times.  Timing is
+ * 			the median and fastest run; the control results are the same every run, so they double as a
+ * 			regression check on the probe, controller and model: if any run's loop count, overshoot, hold error
+ * 			or heater energy is off the expected values the results are still printed, but the exit status is 1.
+ * 			Printed as JSON in BrewBench's layout:
+ * 				{"suite": "brew-kettle", "schema": 1, "config": {...},
+ * 				 "results": [{"name", "iterations", "ns_per_op", "ns_per_op_min", "ops_per_sec", ...}, ...]}
+ *
+ * 			Build & run:	- cmake -S .. -B build && cmake --build build --target KettleBench
+ * 							- build/KettleBench
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#include "gpioPin.h"
+#include "TemperatureProbe.h"
+#include "SimulatedKettle.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace {
+	const unsigned int REPETITIONS = 5;
+
+	// Control loop period and hysteresis below the target, in simulated microseconds and millidegrees
+	const uint64_t LOOP_USECS = 1000000;
+	const int32_t HYSTERESIS = 200;
+
+	struct Rest {
+		int32_t target;			// millidegrees C
+		uint64_t holdSeconds;	// counted from first reaching the target
+	};
+
+	const Rest SCHEDULE[] = {{66000, 3600}, {76000, 600}};
+
+	// What the default kettle and this schedule give.  The run is deterministic, so the tolerances only allow for
+	// floating point differences between compilers; anything more is a change to the probe, controller or model.
+	const unsigned long EXPECTED_LOOPS = 6706;
+	const unsigned long LOOPS_TOLERANCE = 10;
+	const double EXPECTED_MAX_OVERSHOOT = 0.546;
+	const double EXPECTED_HOLD_RMS_ERROR = 0.239;
+	const double EXPECTED_HEATER_KWH = 1.533;
+	const double TEMPERATURE_TOLERANCE = 0.01;
+	const double ENERGY_TOLERANCE = 0.005;
+
+	struct Run {
+		unsigned long loops;
+		uint64_t simulatedMicroseconds;
+		double wallNanoseconds;
+		double maxOvershoot;	// C, worst probe reading over a rest's target while holding
+		double holdRmsError;	// C, probe readings against the target while holding
+		double heaterKwh;
+	};
+
+	uint64_t now() {
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	}
+
+	// Runs the whole schedule once on a new kettle
+	Run runSchedule() {
+		SimulatedKettle kettle;
+		kettle.setPinSource(SimulatedKettle::GPIO_REGISTERS);
+		TemperatureProbe probe(kettle, SPI_CE0, TemperatureProbe::CELSIUS);
+		gpioPin heater(HE_PIN, gpioPin::OUT);
+		gpioPin pump(PUMP_PIN, gpioPin::OUT);
+
+		Run run = {0, 0, 0, 0, 0, 0};
+		double squaredError = 0;
+		unsigned long holdReadings = 0;
+
+		uint64_t start = now();
+		pump.On();
+
+		for (const Rest &rest : SCHEDULE) {
+			bool holding = false;
+			uint64_t holdEnd = 0;
+
+			while (!holding || kettle.now() < holdEnd) {
+				uint64_t loopStart = kettle.now();
+
+				int32_t reading = probe.getMillidegrees<TemperatureProbe::CELSIUS>().value;
+				if (reading < rest.target - HYSTERESIS) {
+					heater.On();
+				} else if (reading >= rest.target) {
+					heater.Off();
+				}
+
+				if (!holding && reading >= rest.target) {
+					holding = true;
+					holdEnd = loopStart + rest.holdSeconds * 1000000ULL;
+				}
+				if (holding) {
+					double error = (reading - rest.target) / 1000.0;
+					squaredError += error * error;
+					holdReadings++;
+					if (error > run.maxOvershoot) {
+						run.maxOvershoot = error;
+					}
+				}
+
+				run.loops++;
+				kettle.wait((unsigned int)(loopStart + LOOP_USECS - kettle.now()));
+			}
+		}
+
+		heater.Off();
+		pump.Off();
+		run.wallNanoseconds = (double)(now() - start);
+		run.simulatedMicroseconds = kettle.now();
+		run.holdRmsError = std::sqrt(squaredError / holdReadings);
+		run.heaterKwh = kettle.getHeaterEnergy() / 3.6e6;
+
+		return run;
+	}
+
+	// Cost of stepping the model alone
+	double stepNanoseconds(unsigned long steps) {
+		SimulatedKettle kettle;
+		kettle.setHeater(true);
+		kettle.setPump(true);
+
+		uint64_t start = now();
+		for (unsigned long i = 0; i < steps; i++) {
+			kettle.wait(SimulatedKettle::STEP_USECS);
+		}
+
+		return (double)(now() - start) / steps;
+	}
+
+	// Prints what in run is outside the expected results, returns false if anything is
+	bool checkRun(const Run &run) {
+		bool good = true;
+
+		if (run.loops + LOOPS_TOLERANCE < EXPECTED_LOOPS || run.loops > EXPECTED_LOOPS + LOOPS_TOLERANCE) {
+			fprintf(stderr, "KettleBench: %lu loops, expected %lu\n", run.loops, EXPECTED_LOOPS);
+			good = false;
+		}
+
+		const struct {
+			const char *name;
+			double value;
+			double expected;
+			double tolerance;
+		} checks[] = {
+			{"max_overshoot_c", run.maxOvershoot, EXPECTED_MAX_OVERSHOOT, TEMPERATURE_TOLERANCE},
+			{"hold_rms_error_c", run.holdRmsError, EXPECTED_HOLD_RMS_ERROR, TEMPERATURE_TOLERANCE},
+			{"heater_kwh", run.heaterKwh, EXPECTED_HEATER_KWH, ENERGY_TOLERANCE}
+		};
+		for (const auto &c : checks) {
+			if (std::fabs(c.value - c.expected) > c.tolerance) {
+				fprintf(stderr, "KettleBench: %s is %.4f, expected %.3f +- %.3f\n", c.name, c.value, c.expected,
+						c.tolerance);
+				good = false;
+			}
+		}
+
+		return good;
+	}
+
+	void writeFile(const std::string &path, const std::string &contents) {
+		std::ofstream file(path.c_str());
+		file << contents;
+		if (!file) {
+			throw std::ofstream::failure("Unable to create " + path);
+		}
+	}
+}
+
+int main() {
+	// gpioPin maps a file standing in for /dev/gpiomem
+	char pattern[] = "/tmp/kettlebench.XXXXXX";
+	if (mkdtemp(pattern) == NULL || mkdir((std::string(pattern) + "/dev").c_str(), 0700) != 0) {
+		fprintf(stderr, "KettleBench: unable to create the fake root\n");
+		return 1;
+	}
+	std::string root = pattern;
+	gpioPin::setSystemRoot(root);
+
+	int status = 0;
+	std::vector<Run> runs;
+	std::vector<double> steps;
+	try {
+		writeFile(root + "/dev/gpiomem", std::string(BLOCK_SIZE, '\0'));
+
+		for (unsigned int r = 0; r < REPETITIONS; r++) {
+			runs.push_back(runSchedule());
+			steps.push_back(stepNanoseconds(1000000));
+		}
+	} catch (std::exception &e) {
+		fprintf(stderr, "KettleBench: %s\n", e.what());
+		status = 1;
+	}
+
+	gpioPin::unmapRegisters();
+	unlink((root + "/dev/gpiomem").c_str());
+	rmdir((root + "/dev").c_str());
+	rmdir(root.c_str());
+
+	if (status != 0) {
+		return status;
+	}
+
+	// Every run has to match, not just the median one.  Report the first that doesn't.
+	bool expected = true;
+	for (const Run &run : runs) {
+		if (!checkRun(run)) {
+			expected = false;
+			break;
+		}
+	}
+
+	std::sort(runs.begin(), runs.end(), [](const Run &a, const Run &b) {
+		return a.wallNanoseconds < b.wallNanoseconds;
+	});
+	std::sort(steps.begin(), steps.end());
+	const Run &median = runs[REPETITIONS / 2];
+	double simulatedSeconds = median.simulatedMicroseconds * 1e-6;
+	double wallSeconds = median.wallNanoseconds * 1e-9;
+	double loopNanoseconds = median.wallNanoseconds / median.loops;
+
+	SimulatedKettle::Parameters kettle;
+	printf("{\n");
+	printf("  \"suite\": \"brew-kettle\",\n");
+	printf("  \"schema\": 1,\n");
+	printf("  \"config\": {\"compiler\": \"%s\", \"repetitions\": %u, \"water_litres\": %.1f, \"heater_watts\": %.0f, "
+			"\"loop_ms\": %llu, \"hysteresis_c\": %.3f},\n", __VERSION__, REPETITIONS, kettle.waterLitres,
+			kettle.heaterWatts, (unsigned long long)(LOOP_USECS / 1000), HYSTERESIS / 1000.0);
+	printf("  \"results\": [\n");
+	printf("    {\"name\": \"mash_schedule_loop\", \"iterations\": %lu, \"ns_per_op\": %.2f, \"ns_per_op_min\": %.2f, "
+			"\"ops_per_sec\": %.0f, \"simulated_seconds\": %.1f, \"wall_seconds\": %.4f, \"speedup\": %.0f, "
+			"\"max_overshoot_c\": %.3f, \"hold_rms_error_c\": %.3f, \"heater_kwh\": %.3f},\n", median.loops,
+			loopNanoseconds, runs[0].wallNanoseconds / runs[0].loops, 1e9 / loopNanoseconds, simulatedSeconds,
+			wallSeconds, simulatedSeconds / wallSeconds, median.maxOvershoot, median.holdRmsError, median.heaterKwh);
+	printf("    {\"name\": \"kettle_step\", \"iterations\": %u, \"ns_per_op\": %.2f, \"ns_per_op_min\": %.2f, "
+			"\"ops_per_sec\": %.0f}\n", 1000000, steps[REPETITIONS / 2], steps[0], 1e9 / steps[REPETITIONS / 2]);
+	printf("  ]\n");
+	printf("}\n");
+
+	return expected ? 0 : 1;
+}
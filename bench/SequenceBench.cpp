@@ -0,0 +1,163 @@
+/*
+ * SequenceBench.cpp - edge timing of SequencePlayer.  Plays a schedule toggling PUMP_PIN every millisecond (and
+ * 			HE_PIN along with every other pump cycle) several times on the same player, and reports how far each
+ * 			edge was written from its deadline, from getEdgeErrors().  gpioPin maps a file standing in for
+ * 			/dev/gpiomem, so it runs anywhere; the errors are the scheduling error of the host, which is what
+ * 			SequencePlayer adds on a Pi too.  Run under SCHED_FIFO (chrt -f 50) to see what the rig would get.
+ *
+ * 			Printed as JSON in BrewBench's layout:
+ * 				{"suite": "brew-sequence", "schema": 1, "config": {...},
+ * 				 "results": [{"name", "edges", "min_ns", "mean_ns", "p50_ns", "p99_ns", "max_ns"}, ...]}
+ * 			Errors are signed: positive is late.
+ *
+ * 			Build & run:	- cmake -S .. -B build && cmake --build build --target SequenceBench
+ * 							- build/SequenceBench [plays]
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#include "gpioPin.h"
+#include "SequencePlayer.h"
+#include "PinAssignments.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace {
+	const unsigned int EDGES = 1000;
+	const uint64_t EDGE_INTERVAL_NS = 1000000;
+
+	struct Stats {
+		size_t edges;
+		int64_t min;
+		double mean;
+		int64_t p50;
+		int64_t p99;
+		int64_t max;
+	};
+
+	Stats summarize(std::vector<int64_t> errors) {
+		Stats stats = {errors.size(), 0, 0, 0, 0, 0};
+		if (errors.empty()) {
+			return stats;
+		}
+
+		std::sort(errors.begin(), errors.end());
+		double sum = 0;
+		for (int64_t error : errors) {
+			sum += error;
+		}
+
+		stats.min = errors.front();
+		stats.mean = sum / errors.size();
+		stats.p50 = errors[errors.size() / 2];
+		stats.p99 = errors[errors.size() * 99 / 100];
+		stats.max = errors.back();
+
+		return stats;
+	}
+
+	void printStats(const char *name, const Stats &stats, bool last) {
+		printf("    {\"name\": \"%s\", \"edges\": %zu, \"min_ns\": %lld, \"mean_ns\": %.1f, \"p50_ns\": %lld, "
+				"\"p99_ns\": %lld, \"max_ns\": %lld}%s\n", name, stats.edges, (long long)stats.min, stats.mean,
+				(long long)stats.p50, (long long)stats.p99, (long long)stats.max, last ? "" : ",");
+	}
+}
+
+int main(int argc, char *argv[]) {
+	unsigned long plays = (argc > 1) ? strtoul(argv[1], NULL, 10) : 3;
+	if (plays == 0) {
+		plays = 1;
+	}
+
+	// gpioPin maps a file standing in for /dev/gpiomem
+	char pattern[] = "/tmp/sequencebench.XXXXXX";
+	if (mkdtemp(pattern) == NULL || mkdir((std::string(pattern) + "/dev").c_str(), 0700) != 0) {
+		fprintf(stderr, "SequenceBench: unable to create the fake root\n");
+		return 1;
+	}
+	std::string root = pattern;
+	gpioPin::setSystemRoot(root);
+
+	int status = 0;
+	std::vector<int64_t> all;
+	std::vector<Stats> perPlay;
+	try {
+		{
+			std::ofstream gpiomem((root + "/dev/gpiomem").c_str());
+			gpiomem << std::string(BLOCK_SIZE, '\0');
+			if (!gpiomem) {
+				throw std::ofstream::failure("Unable to create the fake gpiomem.");
+			}
+		}
+
+		gpioPin pump(PUMP_PIN, gpioPin::OUT);
+		gpioPin heater(HE_PIN, gpioPin::OUT);
+
+		std::vector<SequencePlayer::Step> steps;
+		// The pump goes on at even edges and off at odd ones, the heater goes with it every other cycle
+		for (unsigned int i = 0; i < EDGES; i++) {
+			uint32_t mask = 1u << PUMP_PIN;
+			if (i % 4 < 2) {
+				mask |= 1u << HE_PIN;
+			}
+
+			SequencePlayer::Step step = {i * EDGE_INTERVAL_NS, 0, 0};
+			if (i % 2 == 0) {
+				step.setMask = mask;
+			} else {
+				step.clearMask = mask;
+			}
+			steps.push_back(step);
+		}
+
+		// Replay on the same player, which also checks a finished schedule can be started again
+		SequencePlayer player(steps);
+		for (unsigned long p = 0; p < plays; p++) {
+			player.start();
+			player.wait();
+
+			std::vector<int64_t> errors = player.getEdgeErrors();
+			if (errors.size() != EDGES) {
+				throw std::runtime_error("Sequence did not play every edge.");
+			}
+			perPlay.push_back(summarize(errors));
+			all.insert(all.end(), errors.begin(), errors.end());
+		}
+	} catch (std::exception &e) {
+		fprintf(stderr, "SequenceBench: %s\n", e.what());
+		status = 1;
+	}
+
+	gpioPin::unmapRegisters();
+	unlink((root + "/dev/gpiomem").c_str());
+	rmdir((root + "/dev").c_str());
+	rmdir(root.c_str());
+
+	if (status != 0) {
+		return status;
+	}
+
+	printf("{\n");
+	printf("  \"suite\": \"brew-sequence\",\n");
+	printf("  \"schema\": 1,\n");
+	printf("  \"config\": {\"compiler\": \"%s\", \"plays\": %lu, \"edges\": %u, \"edge_interval_ns\": %llu},\n",
+			__VERSION__, plays, EDGES, (unsigned long long)EDGE_INTERVAL_NS);
+	printf("  \"results\": [\n");
+	for (size_t p = 0; p < perPlay.size(); p++) {
+		std::string name = "edge_error_play_" + std::to_string(p);
+		printStats(name.c_str(), perPlay[p], false);
+	}
+	printStats("edge_error", summarize(all), true);
+	printf("  ]\n");
+	printf("}\n");
+
+	return 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * TracerBench.cpp - measures what EventTracer costs per recorded event, so the instrumentation can be kept in
+ * 			production builds.  Reports the bare clock read, a full record() and a record() with tracing disabled.
+ *
+ * 			Build & run:	- cmake -S .. -B build && cmake --build build --target TracerBench
+ * 							- build/TracerBench [events]
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#include "EventTracer.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char *argv[]) {
+	unsigned int events = (argc > 1) ? atoi(argv[1]) : 10000000;
+	uint64_t start, elapsed;
+	volatile uint64_t sink = 0;
+
+	// Bare clock read, the floor for any event
+	start = EventTracer::now();
+	for (unsigned int i = 0; i < events; i++) {
+		sink = sink + EventTracer::now();
+	}
+	elapsed = EventTracer::now() - start;
+	printf("clock read:         %6.1f ns/event\n", (double)elapsed / events);
+
+	// Full record(), wrapping the ring buffer many times over
+	start = EventTracer::now();
+	for (unsigned int i = 0; i < events; i++) {
+		EventTracer::record(EventTracer::COUNTER, "bench", i & 31, i & 1);
+	}
+	elapsed = EventTracer::now() - start;
+	printf("record():           %6.1f ns/event\n", (double)elapsed / events);
+
+	// record() while disabled at run time
+	EventTracer::setEnabled(false);
+	start = EventTracer::now();
+	for (unsigned int i = 0; i < events; i++) {
+		EventTracer::record(EventTracer::COUNTER, "bench", i & 31, i & 1);
+	}
+	elapsed = EventTracer::now() - start;
+	printf("record() disabled:  %6.1f ns/event\n", (double)elapsed / events);
+	EventTracer::setEnabled(true);
+
+	// Dump what is left in the ring buffer to make sure it is usable
+	unsigned int written = EventTracer::writeChromeTrace("TracerBench.json");
+	printf("wrote %u events to TracerBench.json\n", written);
+
+	return 0;
+}
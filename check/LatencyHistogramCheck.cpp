@@ -0,0 +1,120 @@
+/*
+ * LatencyHistogramCheck.cpp - checks LatencyHistogram's bucketing and snapshot() against known samples: the edges
+ * 			of the linear buckets (15, 16), the first and second power of two ranges (31, 32, 33) and the open ended
+ * 			last bucket (2^38).  Prints each failure and exits non-zero if there are any.  record() is called
+ * 			directly, so it runs with or without BREW_LATENCY_HISTOGRAMS.
+ *
+ * 			Build & run:	- cmake -S .. -B build && cmake --build build --target LatencyHistogramCheck
+ * 							- build/LatencyHistogramCheck	(or ctest --test-dir build)
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#include "LatencyHistogram.h"
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+	unsigned int failures = 0;
+
+	void expect(const char *what, uint64_t actual, uint64_t expected) {
+		if (actual != expected) {
+			printf("FAIL %s: %llu, expected %llu\n", what, (unsigned long long)actual, (unsigned long long)expected);
+			failures++;
+		}
+	}
+
+	void checkBuckets() {
+		const uint64_t TOP = 1ULL << (LatencyHistogram::MAX_EXPONENT + 1);	// 2^38
+		const unsigned int LAST = LatencyHistogram::BUCKET_COUNT - 1;
+
+		// One bucket per value below 16, then 16 buckets 1 wide for 16-31, then 2 wide for 32-63
+		expect("bucketIndex(15)", LatencyHistogram::bucketIndex(15), 15);
+		expect("bucketIndex(16)", LatencyHistogram::bucketIndex(16), 16);
+		expect("bucketIndex(31)", LatencyHistogram::bucketIndex(31), 31);
+		expect("bucketIndex(32)", LatencyHistogram::bucketIndex(32), 32);
+		expect("bucketIndex(33)", LatencyHistogram::bucketIndex(33), 32);
+		expect("bucketIndex(34)", LatencyHistogram::bucketIndex(34), 33);
+		expect("bucketUpperBound(15)", LatencyHistogram::bucketUpperBound(15), 15);
+		expect("bucketUpperBound(16)", LatencyHistogram::bucketUpperBound(16), 16);
+		expect("bucketUpperBound(31)", LatencyHistogram::bucketUpperBound(31), 31);
+		expect("bucketUpperBound(32)", LatencyHistogram::bucketUpperBound(32), 33);
+
+		// The last bucket holds the top sub-bucket of 2^37 and everything from 2^38 up
+		expect("BUCKET_COUNT", LatencyHistogram::BUCKET_COUNT, 560);
+		expect("bucketIndex(2^38 - 1)", LatencyHistogram::bucketIndex(TOP - 1), LAST);
+		expect("bucketIndex(2^38)", LatencyHistogram::bucketIndex(TOP), LAST);
+		expect("bucketIndex(UINT64_MAX)", LatencyHistogram::bucketIndex(UINT64_MAX), LAST);
+		expect("bucketUpperBound(last - 1)", LatencyHistogram::bucketUpperBound(LAST - 1),
+				TOP - (1ULL << (LatencyHistogram::MAX_EXPONENT - LatencyHistogram::SUB_BUCKET_BITS)) - 1);
+		expect("bucketUpperBound(last)", LatencyHistogram::bucketUpperBound(LAST), UINT64_MAX);
+
+		// Every value lands in a bucket whose bound covers it, and bounds only go up
+		for (unsigned int i = 0; i + 1 < LatencyHistogram::BUCKET_COUNT; i++) {
+			uint64_t bound = LatencyHistogram::bucketUpperBound(i);
+			expect("bucketIndex(bucketUpperBound(i))", LatencyHistogram::bucketIndex(bound), i);
+			expect("bucketIndex(bucketUpperBound(i) + 1)", LatencyHistogram::bucketIndex(bound + 1), i + 1);
+		}
+	}
+
+	void checkSnapshot(const char *name, LatencyHistogram::OPERATION op, uint64_t count, uint64_t mean, uint64_t p50,
+			uint64_t p99, uint64_t p999, uint64_t max) {
+		LatencyHistogram::Snapshot s = LatencyHistogram::snapshot(op);
+		const struct {
+			const char *field;
+			uint64_t actual;
+			uint64_t expected;
+		} fields[] = {{"count", s.count, count}, {"mean", s.mean, mean}, {"p50", s.p50, p50}, {"p99", s.p99, p99},
+				{"p999", s.p999, p999}, {"max", s.max, max}};
+
+		for (const auto &f : fields) {
+			char what[64];
+			snprintf(what, sizeof(what), "%s %s", name, f.field);
+			expect(what, f.actual, f.expected);
+		}
+	}
+
+	void checkSnapshots() {
+		const uint64_t TOP = 1ULL << (LatencyHistogram::MAX_EXPONENT + 1);
+
+		LatencyHistogram::reset();
+
+		// Either side of the first two bucket width changes.  p99 is 32's bucket (32-33), capped at the max.
+		LatencyHistogram::record(LatencyHistogram::SPI_TRANSFER, 16);
+		LatencyHistogram::record(LatencyHistogram::SPI_TRANSFER, 31);
+		LatencyHistogram::record(LatencyHistogram::SPI_TRANSFER, 32);
+		checkSnapshot("boundaries", LatencyHistogram::SPI_TRANSFER, 3, 26, 31, 32, 32, 32);
+
+		// Past the last bucket's range the percentiles are the largest sample, not the last bucket's lower edge
+		LatencyHistogram::record(LatencyHistogram::DRDY_WAIT, 1000);
+		LatencyHistogram::record(LatencyHistogram::DRDY_WAIT, TOP);
+		LatencyHistogram::record(LatencyHistogram::DRDY_WAIT, TOP);
+		checkSnapshot("overflow", LatencyHistogram::DRDY_WAIT, 3, (1000 + 2 * TOP) / 3, TOP, TOP, TOP, TOP);
+
+		// 1000 samples of 100ns (bucket 100-103) and one outlier: every percentile is the bucket, max the outlier
+		for (unsigned int i = 0; i < 1000; i++) {
+			LatencyHistogram::record(LatencyHistogram::SYSFS_WRITE, 100);
+		}
+		LatencyHistogram::record(LatencyHistogram::SYSFS_WRITE, 5000);
+		checkSnapshot("outlier", LatencyHistogram::SYSFS_WRITE, 1001, 104, 103, 103, 103, 5000);
+
+		// Nothing recorded, and nothing left after a reset
+		checkSnapshot("empty", LatencyHistogram::GPIO_WRITE, 0, 0, 0, 0, 0, 0);
+		LatencyHistogram::reset();
+		checkSnapshot("reset", LatencyHistogram::SPI_TRANSFER, 0, 0, 0, 0, 0, 0);
+	}
+}
+
+int main() {
+	checkBuckets();
+	checkSnapshots();
+
+	if (failures != 0) {
+		printf("LatencyHistogramCheck: %u failures\n", failures);
+		return 1;
+	}
+
+	printf("LatencyHistogramCheck: ok\n");
+	return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * PeripheralBaseCheck.cpp - checks how gpioPin finds the GPIO registers, against a fake root in a temporary
+ * 			directory.  For each device tree layout (none, one cell CPU addresses as on the Pi 1-3, two cells as
+ * 			on the Pi 4) it checks peripheralBase(), then maps a sparse file standing in for /dev/mem and checks the
+ * 			registers land at peripheralBase() + GPIO_OFFSET in it: a marker written there reads back through
+ * 			registers(), and On() writes the set register at the right offset.  It also checks /dev/gpiomem is
+ * 			preferred, from offset 0, when both are there.  The real /dev/mem is never opened.
+ *
+ * 			Prints each failure and exits non-zero if there are any.
+ *
+ * 			Build & run:	- cmake -S .. -B build && cmake --build build --target PeripheralBaseCheck
+ * 							- build/PeripheralBaseCheck	(or ctest --test-dir build)
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Dana K.
+ */
+
+#include "gpioPin.h"
+#include "PinAssignments.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace {
+	const uint32_t MARKER = 0x5a5a1234;
+
+	unsigned int failures = 0;
+
+	void expect(const std::string &what, uint64_t actual, uint64_t expected) {
+		if (actual != expected) {
+			printf("FAIL %s: 0x%llx, expected 0x%llx\n", what.c_str(), (unsigned long long)actual,
+					(unsigned long long)expected);
+			failures++;
+		}
+	}
+
+	void writeFile(const std::string &path, const std::string &contents) {
+		std::ofstream file(path.c_str(), std::ios::binary);
+		file << contents;
+		if (!file) {
+			throw std::ofstream::failure("Unable to create " + path);
+		}
+	}
+
+	// Creates path as a sparse file of size bytes holding word at offset
+	void writeSparseFile(const std::string &path, off_t size, off_t offset, uint32_t word) {
+		int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+		if (fd < 0) {
+			throw std::runtime_error("Unable to create " + path);
+		}
+
+		bool written = ftruncate(fd, size) == 0 && pwrite(fd, &word, sizeof(word), offset) == sizeof(word);
+		close(fd);
+		if (!written) {
+			throw std::runtime_error("Unable to write " + path);
+		}
+	}
+
+	uint32_t readWord(const std::string &path, off_t offset) {
+		uint32_t word = 0;
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0 || pread(fd, &word, sizeof(word), offset) != sizeof(word)) {
+			if (fd >= 0) {
+				close(fd);
+			}
+			throw std::runtime_error("Unable to read " + path);
+		}
+		close(fd);
+
+		return word;
+	}
+
+	// Maps the registers from root, checks MARKER reads back as the first register and that turning PUMP_PIN on
+	// writes the set register in path at offset, the start of the GPIO block in it
+	void checkMapping(const std::string &name, const std::string &path, off_t offset) {
+		gpioPin::unmapRegisters();
+		gpioPin::mapRegisters();
+		expect(name + " first register", gpioPin::registers()[0], MARKER);
+
+		{
+			gpioPin pump(PUMP_PIN, gpioPin::OUT);
+			pump.On();
+		}
+		gpioPin::unmapRegisters();
+
+		expect(name + " set register", readWord(path, offset + gpioPin::SET_OFFSET * 4), 1u << PUMP_PIN);
+	}
+}
+
+int main() {
+	char pattern[] = "/tmp/peripheralbasecheck.XXXXXX";
+	if (mkdtemp(pattern) == NULL) {
+		fprintf(stderr, "PeripheralBaseCheck: unable to create the fake root\n");
+		return 1;
+	}
+	std::string root = pattern;
+	std::string ranges = root + "/proc/device-tree/soc/ranges";
+	std::string mem = root + "/dev/mem";
+	std::string gpiomem = root + "/dev/gpiomem";
+	gpioPin::setSystemRoot(root);
+
+	// The cells are big endian: bus address, CPU address, size
+	struct Case {
+		const char *board;
+		std::string ranges;
+		uint32_t base;
+	};
+	const Case cases[] = {
+		{"no device tree", "", 0x20000000},
+		{"Pi 2/3", std::string("\x7e\x00\x00\x00\x3f\x00\x00\x00\x01\x00\x00\x00", 12), 0x3f000000},
+		{"Pi 4", std::string("\x7e\x00\x00\x00\x00\x00\x00\x00\xfe\x00\x00\x00\x01\x80\x00\x00", 16), 0xfe000000}
+	};
+
+	int status = 0;
+	try {
+		const char *dirs[] = {"/dev", "/proc", "/proc/device-tree", "/proc/device-tree/soc"};
+		for (const char *dir : dirs) {
+			if (mkdir((root + dir).c_str(), 0700) != 0) {
+				throw std::runtime_error("Unable to create " + root + dir);
+			}
+		}
+
+		for (const Case &c : cases) {
+			unlink(ranges.c_str());
+			if (!c.ranges.empty()) {
+				writeFile(ranges, c.ranges);
+			}
+			expect(std::string(c.board) + " peripheralBase()", gpioPin::peripheralBase(), c.base);
+
+			// No /dev/gpiomem: the block is mapped from /dev/mem at the peripheral base, which the file only
+			// reaches as a sparse file
+			off_t offset = (off_t)c.base + GPIO_OFFSET;
+			writeSparseFile(mem, offset + BLOCK_SIZE, offset, MARKER);
+			checkMapping(std::string(c.board) + " /dev/mem", mem, offset);
+		}
+
+		// With both there /dev/gpiomem wins, and holds just the block
+		writeSparseFile(gpiomem, BLOCK_SIZE, 0, MARKER);
+		checkMapping("/dev/gpiomem", gpiomem, 0);
+	} catch (std::exception &e) {
+		printf("FAIL %s\n", e.what());
+		status = 1;
+	}
+
+	gpioPin::unmapRegisters();
+	unlink(gpiomem.c_str());
+	unlink(mem.c_str());
+	unlink(ranges.c_str());
+	const char *dirs[] = {"/proc/device-tree/soc", "/proc/device-tree", "/proc", "/dev", ""};
+	for (const char *dir : dirs) {
+		rmdir((root + dir).c_str());
+	}
+
+	if (status != 0 || failures != 0) {
+		printf("PeripheralBaseCheck: %u failures\n", failures + status);
+		return 1;
+	}
+
+	printf("PeripheralBaseCheck: ok\n");
+	return 0;
+}
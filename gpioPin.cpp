@@ -10,57 +10,103 @@
 // Initialize default values for static members.
 void *gpioPin::gpioMap = NULL;
 volatile uint32_t *gpioPin::gpio = NULL;
+std::string gpioPin::systemRoot = "";
 
 gpioPin::gpioPin(uint32_t newPin, DIRECTION dir) :
-		SET_OFFSET(7),
-		CLR_OFFSET(10),
-		LVL_OFFSET(13),
 		pin(newPin),
 		pinBitShift(1<<pin),
 		currentDirection(dir)
 {
+	// Make sure the registers are mapped
+	mapRegisters();
+
+	// Set the direction
+	this->direction(currentDirection);
+}
+
+gpioPin::~gpioPin() {
+
+}
+
+void gpioPin::mapRegisters() {
 	// See if gpioMap & gpio have been initialized.  If not, do it!
 	if (gpioMap == NULL) {
-		// Open /dev/mem
-		int mem_fd;
-		if ((mem_fd = open("/dev/mem",  O_RDWR|O_SYNC)) < 0) {
-			throw std::runtime_error("Can't Open /dev/mem.");
+		// Open /dev/gpiomem, which maps just the GPIO registers.  If it isn't there open /dev/mem and map them
+		// from the peripheral base.
+		off_t offset = 0;
+		int mem_fd = open((systemRoot + "/dev/gpiomem").c_str(), O_RDWR|O_SYNC);
+		if (mem_fd < 0) {
+			if ((mem_fd = open((systemRoot + "/dev/mem").c_str(),  O_RDWR|O_SYNC)) < 0) {
+				throw std::runtime_error("Can't Open /dev/gpiomem or /dev/mem.");
+			}
+			offset = (off_t)peripheralBase() + GPIO_OFFSET;
 		}
 
 		// Map GPIO
-		gpioMap = mmap(
+		void *map = mmap(
 				NULL,					// Any address in our space will do
 				BLOCK_SIZE,				// Map Length
 				PROT_READ|PROT_WRITE,	// Enable reading & writing to mapped memory
 				MAP_SHARED,				// Shared with other processes
 				mem_fd,					// File to map
-				GPIO_BASE				// Offset to GPIO Peripheral
+				offset					// Offset to GPIO Peripheral
 		);
 
 		// Close mem_fd
 		close(mem_fd);
 
 		// Make sure the mapping succeeded.
-		if (gpioMap == MAP_FAILED) {
+		if (map == MAP_FAILED) {
 			std::ostringstream stream;
-			stream << "mmap error " << (int)gpioMap;
+			stream << "mmap error " << errno;
 			throw std::runtime_error(stream.str());
 		}
 
 		// Set up our volatile pointer
+		gpioMap = map;
 		gpio = (volatile uint32_t *)gpioMap;
+		barrier();
 	}
+}
 
-	// Set the direction
-	this->direction(currentDirection);
+void gpioPin::unmapRegisters() {
+	if (gpioMap != NULL) {
+		barrier();
+		munmap(gpioMap, BLOCK_SIZE);
+		gpioMap = NULL;
+		gpio = NULL;
+	}
 }
 
-gpioPin::~gpioPin() {
+void gpioPin::setSystemRoot(const std::string &root) {
+	systemRoot = root;
+}
+
+uint32_t gpioPin::peripheralBase() {
+	// ranges holds big endian cells: the peripherals' bus address, then their CPU address and size.  The CPU
+	// address is one cell (Pi 1-3) or two (Pi 4), in which case the first cell is 0 and the address is the next one.
+	std::ifstream ranges((systemRoot + "/proc/device-tree/soc/ranges").c_str(), std::ios::binary);
+	unsigned char cells[12] = {0};
+	ranges.read((char *)cells, sizeof(cells));
+
+	uint32_t base = 0;
+	if (ranges.gcount() >= 8) {
+		base = (cells[4] << 24) | (cells[5] << 16) | (cells[6] << 8) | cells[7];
+	}
+	if (base == 0 && ranges.gcount() >= 12) {
+		base = (cells[8] << 24) | (cells[9] << 16) | (cells[10] << 8) | cells[11];
+	}
+
+	if (base == 0 || base == 0xFFFFFFFF) {
+		base = BCM2708_PERI_BASE;
+	}
 
+	return base;
 }
 
 void gpioPin::direction(DIRECTION dir) {
 	// Always set IN before OUT.  So set in.
+	barrier();
 	currentDirection = IN;
 	*(gpio+(pin/10)) &= ~(7<<((pin%10)*3));
 
@@ -69,6 +115,7 @@ void gpioPin::direction(DIRECTION dir) {
 		currentDirection = OUT;
 		*(gpio+(pin/10)) |= (1<<((pin%10)*3));
 	}
+	barrier();
 }
 
 gpioPin::DIRECTION gpioPin::getDirection() const {
@@ -78,29 +125,45 @@ gpioPin::DIRECTION gpioPin::getDirection() const {
 void gpioPin::On() {
 	// Make sure direction is set to output.  If not, do nothing.
 	if (currentDirection == OUT) {
+		BREW_LATENCY_SCOPE(GPIO_WRITE);
+
 		// Set the pin (turn it on)
 		*(gpio + SET_OFFSET) = pinBitShift;
+		BREW_TRACE_COUNTER("gpioPin", pin, 1);
 	}
 }
 
 void gpioPin::Off() {
 	// Make sure direction is set to output.  If not, do nothing.
 	if (currentDirection == OUT) {
+		BREW_LATENCY_SCOPE(GPIO_WRITE);
+
 		// Clear the pin (turn it off)
 		*(gpio + CLR_OFFSET) = pinBitShift;
+		BREW_TRACE_COUNTER("gpioPin", pin, 0);
 	}
 }
 
+void gpioPin::setBank(uint32_t mask) {
+	*(gpio + SET_OFFSET) = mask;
+}
+
+void gpioPin::clearBank(uint32_t mask) {
+	*(gpio + CLR_OFFSET) = mask;
+}
+
 gpioPin::VALUE gpioPin::Value() const {
 	// variable to hold the return value
 	VALUE pinValue;
 
 	// Read the pins value and see if it is high or low
+	barrier();
 	if ( (*(gpio + LVL_OFFSET) & pinBitShift) != 0 ) {
 		pinValue = HIGH;
 	} else {
 		pinValue = LOW;
 	}
+	barrier();
 
 	return pinValue;
 }
@@ -1,6 +1,15 @@
 /*
  * 	gpioPin.h - Allows the use of GPIO pins on the raspberry pi.  This uses the BCM2835 GPIO numbering
- * 			scheme.
+ * 			scheme.  The pin is chosen at run time; when it is known at compile time StaticGpioPin.h is faster.
+ *
+ * 			The registers are mapped from /dev/gpiomem when it exists, which needs no root and works on every Pi.
+ * 			Otherwise they are mapped from /dev/mem (root only) at the peripheral base read from the device tree
+ * 			(/proc/device-tree/soc/ranges), falling back to the original Pi's 0x20000000.  On 32 bit systems build
+ * 			with -D_FILE_OFFSET_BITS=64 so /dev/mem can be mapped above 2GB (Pi 4).  setSystemRoot() points all
+ * 			of those paths into another directory, e.g. a fake device tree for testing.
+ *
+ * 			The BCM2835 may return reads from different peripherals out of order, so register reads and
+ * 			read-modify-writes are fenced with barrier().  Set & clear are single posted writes and are not.
  *
  * 			@throws - std::runtime_error upon failure to initialize.
  *
@@ -13,14 +22,20 @@
 
 #include <stdexcept>
 #include <sstream>
+#include <fstream>
+#include <string>
 #include <cstdint>
 #include <cstdio>
+#include <cerrno>
 #include <fcntl.h>
+#include <unistd.h>
 #include <sys/mman.h>
+#include "LatencyHistogram.h"
+#include "EventTracer.h"
 
-// Need for Direct Memory Access on the Raspberry PI
+// Need for Direct Memory Access on the Raspberry PI.  BCM2708_PERI_BASE is only used if the device tree can't be read.
 #define BCM2708_PERI_BASE	0x20000000
-#define GPIO_BASE	(BCM2708_PERI_BASE + 0x200000)
+#define GPIO_OFFSET	0x200000
 #define PAGE_SIZE	(4*1024)
 #define BLOCK_SIZE	(4*1024)
 
@@ -76,31 +91,83 @@ public:
 	 */
 	VALUE Value() const;
 
-private:
 	/*
-	 * 	gpioMap - stores the mmap return for future direct access.  Initialized to null.
+	 * 	setBank() / clearBank() - sets or clears every pin in mask (bit n is pin n) with a single register write.  Pins
+	 * 			that are not outputs are unaffected by the hardware.
+	 * 	@pre - a gpioPin must have been constructed so the registers are mapped, and the pins in mask set as outputs.
+	 * 	@params - mask - the pins to change.
 	 */
-	static void *gpioMap;
+	static void setBank(uint32_t mask);
+	static void clearBank(uint32_t mask);
 
 	/*
-	 * 	gpio - once mapped, provides direct pin I/O access.  Initialized to null.
+	 * 	mapRegisters() - maps the GPIO registers if they haven't been already.  Called by every constructor.
+	 * 	@throws - std::runtime_error if the registers can't be mapped.
 	 */
-	static volatile uint32_t *gpio;
+	static void mapRegisters();
+
+	/*
+	 * 	unmapRegisters() - unmaps the GPIO registers so the next mapRegisters() maps them again, e.g. after
+	 * 			setSystemRoot().  No gpioPin may be used until they are mapped again.
+	 */
+	static void unmapRegisters();
+
+	/*
+	 * 	setSystemRoot() - sets the directory /dev and /proc are looked for in.  Defaults to "" (the real root).
+	 * 	@post - the next mapRegisters() looks under root.
+	 */
+	static void setSystemRoot(const std::string &root);
+
+	/*
+	 * 	peripheralBase() - returns the SoC's peripheral base address read from the device tree, or
+	 * 			BCM2708_PERI_BASE if it can't be read.
+	 */
+	static uint32_t peripheralBase();
+
+	/*
+	 * 	barrier() - full memory barrier, for use around reads and read-modify-writes of the registers.
+	 */
+	static void barrier() {
+		__sync_synchronize();
+	}
+
+	/*
+	 * 	registers() - returns the mapped GPIO registers, or null before mapRegisters().
+	 */
+	static volatile uint32_t *registers() {
+		return gpio;
+	}
 
 	/*
 	 *	SET_OFFSET - the memory offset from gpio needed for setting a pin(pin HIGH).
 	 */
-	const uint32_t SET_OFFSET;
+	static constexpr uint32_t SET_OFFSET = 7;
 
 	/*
 	 *	CLR_OFFSET - the memory offset from gpio needed for clearing a pin(pin LOW).
 	 */
-	const uint32_t CLR_OFFSET;
+	static constexpr uint32_t CLR_OFFSET = 10;
 
 	/*
 	 * 	LVL_OFFSET - the memory offset from gpio needed for reading a pins level(HIGH/LOW).
 	 */
-	const uint32_t LVL_OFFSET;
+	static constexpr uint32_t LVL_OFFSET = 13;
+
+private:
+	/*
+	 * 	gpioMap - stores the mmap return for future direct access.  Initialized to null.
+	 */
+	static void *gpioMap;
+
+	/*
+	 * 	gpio - once mapped, provides direct pin I/O access.  Initialized to null.
+	 */
+	static volatile uint32_t *gpio;
+
+	/*
+	 * 	systemRoot - prefix for the /dev and /proc paths used to map the registers.
+	 */
+	static std::string systemRoot;
 
 	/*
 	 *	pin - the pin which is currently being represented.